@@ -23,6 +23,7 @@ details (or else see http://mozilla.org/MPL/2.0/).
 #include "Mona/Logs/Logger.h"
 #include "Mona/Disk/File.h"
 #include "Mona/Util/Util.h"
+#include "Mona/Threading/ThreadPool.h"
 #include <iostream>
 
 namespace Mona {
@@ -78,7 +79,36 @@ protected:
 
 	virtual void			onParamChange(const std::string& key, const std::string* pValue);
 	virtual void			onParamClear();
+
+	/*!
+	Configure placement of a thread (IOSocket, BufferPool, IOFile...) or of a ThreadPool from parameters:
+	- key.affinity, list of processors like "0-3,8" (see Thread::ParseProcessors)
+	- key.spread, ThreadPool only, pins each thread on one processor of the list in turn
+	- key.realTime, real-time scheduling (see Thread::setRealTime)
+	Returns false if key.affinity is invalid, ex: place("io", ioSocket) and place("io.file", ioFile.ioPool()) */
+	template<typename ThreadType>
+	bool					place(const std::string& key, ThreadType& thread) const {
+		std::string value;
+		Thread::Processors processors;
+		if (getString(String::Append(value = key, ".affinity"), value)) {
+			if (!Thread::ParseProcessors(value, processors)) {
+				WARN("Invalid ", key, ".affinity ", value, ", expected a list of processors like 0-3,8");
+				return false;
+			}
+			bool spread(false);
+			getBoolean(key + ".spread", spread);
+			SetAffinity(thread, processors, spread);
+		}
+		bool realTime;
+		if (getBoolean(key + ".realTime", realTime))
+			thread.setRealTime(realTime);
+		return true;
+	}
 private:
+	template<typename ThreadType>
+	static void				SetAffinity(ThreadType& thread, const Thread::Processors& processors, bool spread) { thread.setAffinity(processors); }
+	static void				SetAffinity(ThreadPool& threadPool, const Thread::Processors& processors, bool spread) { threadPool.setAffinity(processors, spread); }
+
 #if !defined(_WIN32)
 	static void HandleSignal(int sig);
 #endif
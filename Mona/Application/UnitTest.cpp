@@ -20,11 +20,17 @@ using namespace std;
 
 namespace Mona {
 
-void UnitTest::Test::run(uint32_t loop) {
+void UnitTest::Test::run(uint32_t loop, const uint32_t* pSeed) {
+	Unique<Scheduler> pScheduler;
+	if (pSeed && scheduled())
+		NOTE(_name, " on deterministic scheduler with seed ", pScheduler.set(*pSeed).seed());
 	_chrono.restart();
 	DEBUG(_name," now running ", loop, " iterations...");
-	for (_loop = 0; _loop < loop; ++_loop)
+	for (_loop = 0; _loop < loop; ++_loop) {
 		TestFunction();
+		if (pScheduler)
+			pScheduler->run();
+	}
 	_chrono.stop();
 	if (loop>1)
 		NOTE(_name, " OK (x", _loop, " ", _chrono.elapsed(), "ms)")
@@ -34,6 +40,8 @@ void UnitTest::Test::run(uint32_t loop) {
 
 int UnitTest::main() {
 	getNumber("arguments.loop", _loop);
+	if (getNumber("arguments.seed", _seed))
+		_pSeed = &_seed;
 	std::string module;
 	if (!getString("arguments.module", module))
 		runSelectedModule();
@@ -57,6 +65,9 @@ void UnitTest::defineOptions(Exception& ex, Options& options) {
 	options.add(ex, "loop", "x", "Specify the number of loop to execute for every test to run.")
 		.argument("number of loop");
 
+	options.add(ex, "seed", "s", "Run scheduled tests on a deterministic scheduler with this seed (0 for a random seed) to replay an interleaving of runners.")
+		.argument("seed");
+
 	// defines here your options applications
 	Application::defineOptions(ex, options);
 }
@@ -83,7 +94,7 @@ void UnitTest::runSelectedModule() {
 
 void UnitTest::runAll(uint32_t loop) {
 	for (auto& itTest : Tests())
-		itTest.second->run(loop);
+		itTest.second->run(loop, _pSeed);
 }
 
 void UnitTest::runOne(const string& mod, uint32_t loop) {
@@ -97,7 +108,7 @@ void UnitTest::runOne(const string& mod, uint32_t loop) {
 
 	// Run all tests of the module
 	for (auto& it = itTest.first; it != itTest.second; it++)
-		it->second->run(loop);
+		it->second->run(loop, _pSeed);
 }
 
 void UnitTest::runAt(const string& mod, uint32_t loop) {
@@ -120,9 +131,9 @@ void UnitTest::runAt(const string& mod, uint32_t loop) {
 				auto range = Tests().equal_range(itTest->first);
 				for (auto& it = range.first; it != range.second; it++) {
 					if (pos == string::npos) // Run all tests of the module
-						it->second->run(loop);
+						it->second->run(loop, _pSeed);
 					else if (!pos--)
-						return it->second->run(loop); // Run a specific subtest
+						return it->second->run(loop, _pSeed); // Run a specific subtest
 				}
 				if (pos == string::npos)
 					return; // otherwise subtest not found
@@ -18,6 +18,7 @@ details (or else see http://mozilla.org/MPL/2.0/).
 
 #include "Mona/Application/Application.h"
 #include "Mona/Timing/Stopwatch.h"
+#include "Mona/Threading/Scheduler.h"
 
 namespace Mona {
 
@@ -26,13 +27,20 @@ struct UnitTest : private Application {
 	struct Test : virtual Object {
 		Test(const std::string& type) : _name(type.data(), type.size() - 4) {}
 
-		void run(uint32_t loop);
+		/*!
+		pSeed runs a scheduled test (see ADD_SCHEDULED_TEST) on a deterministic Scheduler seeded with *pSeed (0 for a random seed),
+		pending runners are run after every loop. Other tests ignore it, they run normally */
+		void run(uint32_t loop, const uint32_t* pSeed = NULL);
 
 	protected:
 		uint32_t	_loop;
 	private:
 		virtual void TestFunction() {}
 			/// \brief The test function to overload
+		/*!
+		Opt-in for the deterministic mode: runners queued by the test are held by the Scheduler until it runs them, so a scheduled test
+		must never wait a pool or handler work (Signal::wait, ThreadPool::join...) but run it with Scheduler::Current()->run() instead */
+		virtual bool scheduled() const { return false; }
 
 		std::string	_name; /// fullname of the test
 		Stopwatch	_chrono;
@@ -50,7 +58,7 @@ struct UnitTest : private Application {
 	};
 
 private:
-	UnitTest(const std::string& version) : _version(version), _loop(1) { setString("description", "Unit tests"); }
+	UnitTest(const std::string& version) : _version(version), _loop(1), _pSeed(NULL) { setString("description", "Unit tests"); }
 
 	static std::multimap<const std::string, Unique<Test>, String::IComparator>& Tests() {
 		static std::multimap<const std::string, Unique<Test>, String::IComparator> _Tests;
@@ -77,6 +85,8 @@ private:
 		/// \brief Try to run the test at index mod (can be in the form XX for 1 module or XX::YY to select 1 specific test index from a module)
 
 	uint32_t				_loop;
+	uint32_t				_seed;
+	const uint32_t*			_pSeed; // deterministic mode
 	const std::string	_version;
 };
 
@@ -90,6 +100,17 @@ private:\
 const bool NAME##TEST::_TestCreated = UnitTest::AddTest<NAME##TEST>();\
 void NAME##TEST::TestFunction()
 
+/// Macro for adding new tests in a Test cpp which can run on a deterministic Scheduler with --seed (see Test::scheduled)
+#define ADD_SCHEDULED_TEST(NAME) struct NAME##TEST : UnitTest::Test { \
+	NAME##TEST(const std::string& type) : UnitTest::Test(type) {}\
+	void TestFunction();\
+private:\
+	bool scheduled() const { return true; }\
+	static const bool _TestCreated;\
+};\
+const bool NAME##TEST::_TestCreated = UnitTest::AddTest<NAME##TEST>();\
+void NAME##TEST::TestFunction()
+
 #if defined(_DEBUG)
 #define ADD_DEBUG_TEST(NAME) ADD_TEST(NAME)
 #else
@@ -20,6 +20,7 @@ details (or else see http://mozilla.org/MPL/2.0/).
 #if !defined(_WIN32)
 #include <fcntl.h>
 #include <sys/file.h>
+#include <sys/uio.h>
 #define INVALID_HANDLE_VALUE -1
 #include <unistd.h>
 #if defined(_BSD) && !defined(lseek64) // not defined on 64 bit systems
@@ -37,7 +38,7 @@ namespace Mona {
 
 File::File(const Path& path, Mode mode) : _flushing(0), _loaded(false), _pDecoder(NULL),
 	_written(0), _readen(0), _path(path), mode(mode), _decodingTrack(0),
-	_queueing(0), _ioTrack(0), _handle(INVALID_HANDLE_VALUE), _externDecoder(false) {
+	_queueing(0), _operations(0), _ioTrack(0), _handle(INVALID_HANDLE_VALUE), _externDecoder(false) {
 }
 
 File::~File() {
@@ -254,6 +255,41 @@ bool File::write(Exception& ex, const void* data, uint32_t size) {
 	return true;
 }
 
+bool File::write(Exception& ex, const PacketList& packets) {
+	if (packets.count() <= 1 || _path.isFolder())
+		return write(ex, packets ? packets.front().data() : NULL, packets.size());
+#if defined(_WIN32)
+	for (const Packet& packet : packets) {
+		if (!write(ex, packet.data(), packet.size()))
+			return false;
+	}
+	return true;
+#else
+	if (!write(ex, NULL, 0)) // load and check permission
+		return false;
+	iovec iovecs[64];
+	PacketList::const_iterator it = packets.begin();
+	while (it != packets.end()) {
+		uint32_t count(0), size(0);
+		do {
+			iovecs[count].iov_base = (void*)it->data();
+			size += (iovecs[count++].iov_len = it->size());
+		} while (++it != packets.end() && count < 64);
+		ssize_t written = ::writev(_handle, iovecs, count);
+		if (written <= 0) {
+			ex.set<Ex::System::File>("Impossible to write ", _path, " (size=", size, ")");
+			return false;
+		}
+		_written += written;
+		if (uint32_t(written) < size) {
+			ex.set<Ex::System::File>("No more disk space to write ", _path, " (size=", size, ")");
+			return false;
+		}
+	}
+	return true;
+#endif
+}
+
 bool File::erase(Exception& ex) {
 	if (mode != MODE_DELETE && mode != MODE_WRITE) {
 		ex.set<Ex::Permission>(_path, " deletion unauthorized in reading or append mode");
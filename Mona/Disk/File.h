@@ -19,6 +19,7 @@ details (or else see http://mozilla.org/MPL/2.0/).
 #include "Mona/Mona.h"
 #include "Mona/Disk/Path.h"
 #include "Mona/Threading/Handler.h"
+#include "Mona/Memory/PacketList.h"
 
 namespace Mona {
 
@@ -86,6 +87,9 @@ struct File : virtual Object {
 	If writing error => Ex::System::File || Ex::Permission */
 	bool				write(Exception& ex, const void* data, uint32_t size);
 	/*!
+	Gather writing of packets (writev) */
+	bool				write(Exception& ex, const PacketList& packets);
+	/*!
 	If deletion error => Ex::System::File || Ex::Permission
 	/!\ One time deleted no more write operation is possible */
 	bool				erase(Exception& ex);
@@ -115,6 +119,7 @@ private:
 
 	std::atomic<uint64_t>			_queueing;
 	std::atomic<uint32_t>			_flushing;
+	std::atomic<uint32_t>			_operations; // actions of IOFile in progress (queued, running or decoding)
 	uint16_t						_ioTrack;
 	uint16_t						_decodingTrack;
 	const Handler*				_pHandler; // to diminue size of Action+Handle
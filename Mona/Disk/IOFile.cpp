@@ -24,6 +24,7 @@ namespace Mona {
 struct IOFile::Action : Runner, virtual Object {
 	Action(const char* name, const Handler& handler, const Shared<File>& pFile) : Runner(name) {
 		pFile->_pHandler = &handler;
+		++pFile->_operations;
 	}
 
 	struct Handle : Runner, virtual Object {
@@ -47,7 +48,9 @@ protected:
 	}
 
 	bool run(Exception& ex, const Shared<File>& pFile) {
-		if (process(ex, pFile))
+		bool success(process(ex, pFile));
+		--pFile->_operations; // after process to count a following action (decoding) before
+		if (success)
 			return true;
 		struct ErrorHandle : Handle, virtual Object {
 			ErrorHandle(const char* name, const Shared<File>& pFile, Exception& ex) : Handle(name, pFile), _ex(move(ex)) {}
@@ -89,6 +92,8 @@ private:
 
 IOFile::IOFile(const Handler& handler, const ThreadPool& threadPool, uint16_t cores) :
 	handler(handler), threadPool(threadPool), _threadPool(Thread::PRIORITY_LOW, cores*2) { // 2*CPU => because disk speed can be at maximum 2x more than memory, and Low priority to not impact main thread pool
+	// elastic from CPU count: the extra threads serve only bursts of disk operations
+	_threadPool.setElastic(_threadPool.threads() / 2);
 }
 
 IOFile::~IOFile() {
@@ -113,7 +118,7 @@ void IOFile::load(const Shared<File>& pFile) {
 	if (*pFile)
 		return;
 	// SAction to allow file creation full asynchronous (without any other hand on the file)
-	_threadPool.queue<SAction>(pFile->_ioTrack, "LoadFile", handler, pFile);
+	queue<SAction>(pFile, "LoadFile", handler, pFile);
 }
 
 void IOFile::read(const Shared<File>& pFile, uint32_t size) {
@@ -170,13 +175,13 @@ void IOFile::read(const Shared<File>& pFile, uint32_t size) {
 		const ThreadPool&	_threadPool;
 	};
 	// always do the job even if size==0 to get a onReaden event!
-	_threadPool.queue<ReadFile>(pFile->_ioTrack, handler, pFile, threadPool, size);
+	queue<ReadFile>(pFile, handler, pFile, threadPool, size);
 }
 
-void IOFile::write(const Shared<File>& pFile, const Packet& packet) {
+void IOFile::write(const Shared<File>& pFile, const PacketList& packets) {
 	struct WriteFile : SAction { // SAction to allow file writing full asynchronous (without any other hand on the file)
-		WriteFile(const Handler& handler, const Shared<File>& pFile, const Packet& packet) : _packet(move(packet)), SAction("WriteFile", handler, pFile) {
-			pFile->_queueing += _packet.size();
+		WriteFile(const Handler& handler, const Shared<File>& pFile, const PacketList& packets) : _packets(move(packets)), SAction("WriteFile", handler, pFile) {
+			pFile->_queueing += _packets.size();
 		}
 	private:
 		struct Handle : Action::Handle, virtual Object {
@@ -188,8 +193,8 @@ void IOFile::write(const Shared<File>& pFile, const Packet& packet) {
 			}
 		};
 		bool process(Exception& ex, const Shared<File>& pFile) {
-			uint64_t queueing = (pFile->_queueing -= _packet.size());
-			if (!pFile->write(ex, _packet.data(), _packet.size()))
+			uint64_t queueing = (pFile->_queueing -= _packets.size());
+			if (!pFile->write(ex, _packets))
 				return false;
 			if (queueing)
 				return true;
@@ -199,12 +204,12 @@ void IOFile::write(const Shared<File>& pFile, const Packet& packet) {
 				--pFile->_flushing;
 			return true;
 		}
-		Packet		 _packet;
+		PacketList	 _packets;
 	};
 	// do the WriteFile even if packet is empty when not loaded to allow to open the file and clear its content or create the file
 	// or to allow to create the folder => if File is a Folder opened in WRITE/APPEND mode loaded is always false and write an empty packet create the folder => allow a folder creation asynchrone!
-	if(packet.size() || !pFile->loaded())
-		_threadPool.queue<WriteFile>(pFile->_ioTrack, handler, pFile, packet);
+	if(packets.size() || !pFile->loaded())
+		queue<WriteFile>(pFile, handler, pFile, packets);
 }
 
 void IOFile::erase(const Shared<File>& pFile) {
@@ -229,7 +234,7 @@ void IOFile::erase(const Shared<File>& pFile) {
 			return true;
 		}
 	};
-	_threadPool.queue<EraseFile>(pFile->_ioTrack, handler, pFile);
+	queue<EraseFile>(pFile, handler, pFile);
 }
 
 
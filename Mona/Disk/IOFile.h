@@ -27,7 +27,7 @@ namespace Mona {
 
 /*!
 IOFile performs asynchrone writing and reading operation,
-It uses a Thread::ProcessorCount() threads with low priority to load/read/write files
+It uses Thread::ProcessorCount() threads with low priority to load/read/write files, and up to twice more on bursts (see ThreadPool::setElastic)
 Indeed even if SSD drive allows parallel reading and writing operation every operation sollicate too the CPU,
 so it's useless to try to exceeds number of CPU core (Thread::ProcessorCount() has been tested and approved with file load) */
 struct IOFile : virtual Object, Thread { // Thread is for file watching!
@@ -38,6 +38,10 @@ struct IOFile : virtual Object, Thread { // Thread is for file watching!
 	const Handler&	  handler;
 	const ThreadPool& threadPool;
 
+	/*!
+	Pool of threads for disk operations, to configure their placement (see ThreadPool::setAffinity) */
+	ThreadPool&		  ioPool() { return _threadPool; }
+
 	/*!
 	Subscribe read */
 	template<typename FileType>
@@ -74,7 +78,10 @@ struct IOFile : virtual Object, Thread { // Thread is for file watching!
 	void read(const Shared<File>& pFile, uint32_t size=0xFFFF);
 	/*!
 	Async write with file load if file not loaded */
-	void write(const Shared<File>& pFile, const Packet& packet);
+	void write(const Shared<File>& pFile, const Packet& packet) { write(pFile, PacketList(std::move(packet))); }
+	/*!
+	Async gather write (writev) with file load if file not loaded */
+	void write(const Shared<File>& pFile, const PacketList& packets);
 	/*!
 	Async file/folder deletion*/
 	void erase(const Shared<File>& pFile);
@@ -90,6 +97,16 @@ private:
 	const std::string& name() const override { static std::string Name("FileWatching"); return Name; }
 	bool run(Exception& ex, const volatile bool& requestStop);
 
+	/*!
+	Queue an operation on the io track of pFile, when nothing is in progress on pFile its track can move first
+	if its thread is drained, to leave a thread retired by elastic mode */
+	template<typename RunnerType, typename ...Args>
+	void queue(const Shared<File>& pFile, Args&&... args) {
+		if (!pFile->_operations)
+			_threadPool.rebalance(pFile->_ioTrack);
+		_threadPool.queue<RunnerType>(pFile->_ioTrack, std::forward<Args>(args)...);
+	}
+
 	struct Action;
 	struct WAction;
 	struct SAction;
@@ -42,6 +42,11 @@ char* BinaryWriter::buffer(uint32_t size) {
 	return _pBuffer->data() + oldSize;
 }
 
+BinaryWriter& BinaryWriter::write(const PacketList& packets) {
+	packets.copy(buffer(packets.size())); // one resize for all packets
+	return *this;
+}
+
 BinaryWriter& BinaryWriter::writeRandom(uint32_t count) {
 	while(count--)
 		write8(Util::Random<uint8_t>());
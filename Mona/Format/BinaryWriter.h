@@ -18,6 +18,7 @@ details (or else see http://mozilla.org/MPL/2.0/).
 
 #include "Mona/Mona.h"
 #include "Mona/Memory/Buffer.h"
+#include "Mona/Memory/PacketList.h"
 
 namespace Mona {
 
@@ -37,6 +38,7 @@ struct BinaryWriter : Bytes, virtual Object {
 	BinaryWriter& write(STRType data) { return append(data, strlen(data)); }
 	BinaryWriter& write(const Bytes& bytes) { return append(EXP(bytes)); }
 	BinaryWriter& write(const std::string& value) { return append(EXP(value)); }
+	BinaryWriter& write(const PacketList& packets);
 	BinaryWriter& write(char value) { return append(&value, sizeof(value)); }
 
 	BinaryWriter& write8(uint8_t value) { return append(&value, sizeof(value)); }
@@ -0,0 +1,122 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#include "Mona/Memory/ArenaAllocator.h"
+#include "Mona/Logs/Logs.h"
+#if !defined(_WIN32)
+#include <sys/mman.h>
+#endif
+
+
+using namespace std;
+
+
+namespace Mona {
+
+ArenaAllocator::ArenaAllocator(uint64_t reserve, bool hugePages, uint8_t cache) : BufferPool(cache),
+	_arena(NULL), _size(0), _hugePages(false), _used(0), _owned(0), _mapping(NULL), _mappingSize(0) {
+	if (!reserve)
+		return;
+	reserve = (reserve + HUGE_PAGE - 1) & ~uint64_t(HUGE_PAGE - 1); // round up to huge page size
+#if defined(_WIN32)
+	SIZE_T largePage = GetLargePageMinimum();
+	if (hugePages && largePage && !(reserve % largePage))
+		_mapping = VirtualAlloc(NULL, SIZE_T(reserve), MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE); // requires SeLockMemoryPrivilege
+	if (_mapping)
+		_hugePages = true;
+	else if (!(_mapping = VirtualAlloc(NULL, SIZE_T(reserve), MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE))) {
+		WARN("ArenaAllocator fails to reserve ", reserve, "B, error ", GetLastError());
+		return;
+	}
+	_arena = (char*)_mapping;
+	_mappingSize = reserve;
+#else
+#if defined(MAP_HUGETLB)
+	if (hugePages) {
+		_mapping = mmap(NULL, reserve, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0); // without MAP_NORESERVE to fail rather than SIGBUS on access
+		if (_mapping == MAP_FAILED)
+			_mapping = NULL; // not enough huge pages configured (see /proc/sys/vm/nr_hugepages)
+		else
+			_hugePages = true;
+	}
+#endif
+	if (_mapping) {
+		_arena = (char*)_mapping;
+		_mappingSize = reserve;
+	} else {
+		// normal pages, reserve one huge page more to align arena on huge page (required by transparent huge pages)
+		_mappingSize = reserve + HUGE_PAGE;
+		_mapping = mmap(NULL, _mappingSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+		if (_mapping == MAP_FAILED) {
+			WARN("ArenaAllocator fails to reserve ", reserve, "B, ", strerror(errno));
+			_mapping = NULL;
+			return;
+		}
+		_arena = (char*)((uintptr_t(_mapping) + HUGE_PAGE - 1) & ~uintptr_t(HUGE_PAGE - 1));
+#if defined(MADV_HUGEPAGE)
+		if (hugePages)
+			madvise(_arena, reserve, MADV_HUGEPAGE); // best effort, ignore failure (THP disabled)
+#endif
+	}
+#endif
+	_size = reserve;
+	DEBUG("ArenaAllocator reserves ", _size, "B", _hugePages ? " with huge pages" : "");
+}
+
+ArenaAllocator::~ArenaAllocator() {
+	if (!_mapping || _owned)
+		return; // no arena, or buffers still alive on static destruction (released with the process)
+#if defined(_WIN32)
+	VirtualFree(_mapping, 0, MEM_RELEASE);
+#else
+	munmap(_mapping, _mappingSize);
+#endif
+}
+
+char* ArenaAllocator::alloc(uint32_t& capacity) {
+	if (capacity < MIN_CAPACITY || !_size)
+		return BufferPool::alloc(capacity);
+	{
+		lock_guard<mutex> lock(_mutex);
+		vector<char*>& slots(_slots[computeIndex(capacity)]);
+		if (!slots.empty()) {
+			char* buffer = slots.back();
+			slots.pop_back();
+			++_owned;
+			return buffer;
+		}
+		// carve a new slot, aligned on its capacity until huge page size
+		uint64_t alignment = min(uint64_t(capacity), uint64_t(HUGE_PAGE)) - 1;
+		uint64_t offset = (_used + alignment) & ~alignment;
+		if (offset + capacity <= _size) {
+			_used = offset + capacity;
+			++_owned;
+			return _arena + offset;
+		}
+	}
+	return BufferPool::alloc(capacity); // arena full
+}
+
+void ArenaAllocator::free(char* buffer, uint32_t capacity) {
+	if (!owns(buffer))
+		return BufferPool::free(buffer, capacity);
+	lock_guard<mutex> lock(_mutex);
+	_slots[computeIndex(capacity)].emplace_back(buffer);
+	--_owned;
+}
+
+
+} // namespace Mona
@@ -0,0 +1,73 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#pragma once
+
+#include "Mona/Mona.h"
+#include "Mona/Memory/BufferPool.h"
+
+namespace Mona {
+
+/*!
+BufferPool which carves buffers bigger than 64KB out of a memory arena reserved on start-up,
+backed by huge pages (MAP_HUGETLB) when available, or else by normal pages advised for transparent huge pages (MADV_HUGEPAGE),
+to avoid mmap/munmap and page faults of every big allocation (file reading for example).
+Arena slots are recycled by capacity and never given back to the system, when arena is full big buffers fall back on BufferPool tiers.
+Smaller buffers are served by BufferPool as usual. Install it on start-up only with Buffer::Allocator::Set<ArenaAllocator>()
+(it's called without lock), if it's replaced later its arena stays mapped until the release of its last arena buffer */
+struct ArenaAllocator : BufferPool, virtual Object {
+	/*!
+	reserve is the arena size in bytes, hugePages tries to back it by explicit huge pages before to advise normal pages */
+	ArenaAllocator(uint64_t reserve = 0x40000000, bool hugePages = true, uint8_t cache = 32);
+	~ArenaAllocator();
+
+	/*!
+	Arena size, 0 if reservation has failed (every buffer is served by BufferPool then) */
+	uint64_t	reserved() const { return _size; }
+	/*!
+	Bytes of arena already carved in slots */
+	uint64_t	used() const { std::lock_guard<std::mutex> lock(_mutex); return _used; }
+	/*!
+	Arena buffers alive */
+	uint64_t	owned() const override { std::lock_guard<std::mutex> lock(_mutex); return _owned; }
+	/*!
+	True if arena is backed by explicit huge pages */
+	bool		hugePages() const { return _hugePages; }
+
+private:
+	char* alloc(uint32_t& capacity) override;
+	void  free(char* buffer, uint32_t capacity) override;
+	bool  range(const char*& begin, const char*& end) const override { begin = _arena; end = _arena + _size; return _size ? true : false; }
+
+	enum {
+		MIN_CAPACITY = 0x20000, // 128KB, smaller buffers are served by BufferPool
+		HUGE_PAGE = 0x200000 // 2MB
+	};
+
+	char*				_arena;
+	uint64_t			_size;
+	bool				_hugePages;
+	uint64_t			_used; // protected by _mutex
+	uint64_t			_owned; // protected by _mutex
+	std::vector<char*>	_slots[28]; // free slots by capacity tier, protected by _mutex
+	mutable std::mutex	_mutex;
+	// original mapping to unmap
+	void*				_mapping;
+	uint64_t			_mappingSize;
+};
+
+
+} // namespace Mona
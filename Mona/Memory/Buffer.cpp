@@ -43,6 +43,8 @@ char* Buffer::Allocator::Alloc(uint32_t& size) {
 		if (size>0x80000000)
 			return new char[size];
 	}
+	if (Concurrent())
+		return Get()->alloc(size);
 	if (!TryLock())
 		return new char[size];
 	char* buffer = Get()->alloc(size);
@@ -55,25 +57,73 @@ void Buffer::Allocator::Free(char* buffer, uint32_t size) {
 			delete[] buffer;
 		return;
 	}
-	if ((size & (size - 1)) || !TryLock())  // check than we have a size create with Alloc (capacity log2) + TryLock working!
+	if (size & (size - 1)) // check than we have a size create with Alloc (capacity log2)
+		return delete[] buffer;
+	if (buffer >= RetiredBegin().load(std::memory_order_acquire) && buffer < RetiredEnd().load(std::memory_order_acquire) && FreeRetired(buffer, size))
+		return;
+	if (Concurrent())
+		return Get()->free(buffer, size);
+	if (!TryLock())
 		return delete[] buffer;
 	Get()->free(buffer, size);
 	Unlock();
 }
 
+void Buffer::Allocator::Retire(Unique<Allocator>& pAllocator) {
+	if (!pAllocator || !pAllocator->owned())
+		return; // deleted
+	Retired().emplace_back(std::move(pAllocator));
+	UpdateRetired();
+}
+
+void Buffer::Allocator::UpdateRetired() {
+	const char* begin(NULL), * end(NULL);
+	for (const Unique<Allocator>& pAllocator : Retired()) {
+		const char* first, * last;
+		if (!pAllocator->range(first, last))
+			continue;
+		if (!begin || first < begin)
+			begin = first;
+		if (last > end)
+			end = last;
+	}
+	// on erasure the range shrinks around the allocators still retired, so a free reading an old bound and a new one still finds them
+	RetiredBegin().store(begin, std::memory_order_release);
+	RetiredEnd().store(end, std::memory_order_release);
+}
+
+bool Buffer::Allocator::FreeRetired(char* buffer, uint32_t size) {
+	Lock();
+	vector<Unique<Allocator>>& retired(Retired());
+	for (auto it = retired.begin(); it != retired.end(); ++it) {
+		Allocator& allocator(**it);
+		if (!allocator.owns(buffer))
+			continue;
+		allocator.free(buffer, size);
+		if (!allocator.owned()) { // last buffer released
+			retired.erase(it);
+			UpdateRetired();
+		}
+		Unlock();
+		return true;
+	}
+	Unlock();
+	return false;
+}
 
-Buffer::Buffer(uint32_t size) : _offset(0), _size(size), _capacity(size) {
+Buffer::Buffer(uint32_t size) : _external(false), _offset(0), _size(size), _capacity(size) {
 	_data = _buffer = Allocator::Alloc(_capacity);
 }
-Buffer::Buffer(const char* data, uint32_t size) : _offset(0), _size(size), _capacity(size) {
+Buffer::Buffer(const char* data, uint32_t size) : _external(false), _offset(0), _size(size), _capacity(size) {
 	memcpy(_data = _buffer = Allocator::Alloc(_capacity), data, size);
 }
 
-Buffer::Buffer(uint32_t size, char* buffer) : _offset(0), _data(buffer), _size(size), _capacity(size), _buffer(NULL) {}
+Buffer::Buffer(uint32_t size, char* buffer) : _external(false), _offset(0), _data(buffer), _size(size), _capacity(size), _buffer(NULL) {}
+Buffer::Buffer(uint32_t size, char* data, bool external) : _external(external), _offset(0), _data(data), _size(size), _capacity(size), _buffer(NULL) {}
 
 Buffer::~Buffer() {
 	if (_buffer)
-		Allocator::Free(_buffer, _capacity);
+		Allocator::Free(_buffer, _capacity + _offset); // original capacity, without clip
 }
 
 Buffer& Buffer::append(const void* data, uint32_t size) {
@@ -134,7 +184,7 @@ Buffer& Buffer::resize(uint32_t size, bool preserveData) {
 		}
 	}
 
-	if (!_buffer)
+	if (!_buffer && !_external)
 		FATAL_ERROR("Static buffer exceeds maximum ",_capacity," bytes capacity");
 
 	// allocate
@@ -146,9 +196,10 @@ Buffer& Buffer::resize(uint32_t size, bool preserveData) {
 		memcpy(_data, oldData, _size);
 
 
-	// deallocate if was allocated
-	if (oldCapacity)
+	// deallocate if was allocated (not external)
+	if (oldCapacity && _buffer)
 		Allocator::Free(_buffer, oldCapacity);
+	_external = false;
 
 	_size = size;
 	_buffer=_data;
@@ -20,6 +20,7 @@ details (or else see http://mozilla.org/MPL/2.0/).
 #include "Mona/Memory/Bytes.h"
 #include <thread>
 #include <atomic>
+#include <vector>
 
 namespace Mona {
 
@@ -54,13 +55,38 @@ struct Buffer : Bytes, virtual Object {
 
 
 	struct Allocator : virtual Object {
+		/*!
+		Change the allocator, to call on start-up: a concurrent allocator is called without lock,
+		so it must not be replaced while other threads allocate buffers.
+		The previous allocator is deleted, or retired if it still owns buffers alive (see owns) until their release.
+		Returns the allocator installed, valid until the next Set call */
 		template<typename AllocatorType=Allocator, typename ...Args>
-		static void   Set(Args&&... args) { Lock(); Get().set<AllocatorType>(std::forward<Args>(args)...); Unlock(); }
+		static AllocatorType& Set(Args&&... args) {
+			Lock();
+			Concurrent() = false;
+			Unique<Allocator> pPrevious(std::move(Get()));
+			AllocatorType& allocator = Get().set<AllocatorType>(std::forward<Args>(args)...);
+			Concurrent() = Get()->concurrent();
+			Retire(pPrevious);
+			Unlock();
+			return allocator;
+		}
 		static char*  Alloc(uint32_t& size);
 		static void	  Free(char* buffer, uint32_t size);
 	protected:
+		/*!
+		Return true if alloc/free are thread-safe, then they are called without the global allocator lock */
+		virtual bool   concurrent() const { return false; }
 		virtual char*  alloc(uint32_t& capacity) { return new char[capacity]; }
 		virtual void   free(char* buffer, uint32_t capacity) { delete[] buffer; }
+		/*!
+		Return true with the address range [begin, end) of buffers which have to be freed by this allocator whatever the allocator installed
+		(not allocated by new[], see ArenaAllocator) */
+		virtual bool   range(const char*& begin, const char*& end) const { return false; }
+		bool		   owns(const char* buffer) const { const char* begin, * end; return range(begin, end) && buffer >= begin && buffer < end; }
+		/*!
+		Count of buffers alive which are owned by this allocator */
+		virtual uint64_t owned() const { return 0; }
 
 		static void Lock() { while (!TryLock()) std::this_thread::yield(); }
 		static void Unlock() { Mutex().clear(std::memory_order_release); }
@@ -69,11 +95,29 @@ struct Buffer : Bytes, virtual Object {
 
 		static Unique<Allocator>& Get() { static Unique<Allocator> PAllocator(SET); return PAllocator; }
 		static std::atomic_flag&  Mutex() { static std::atomic_flag Mutex = ATOMIC_FLAG_INIT; return Mutex; }
-		
+		static std::atomic<bool>& Concurrent() { static std::atomic<bool> Concurrent(false); return Concurrent; }
+		/*!
+		Allocators replaced while they own buffers alive, protected by Mutex */
+		static std::vector<Unique<Allocator>>& Retired() { static std::vector<Unique<Allocator>> Retired; return Retired; }
+		/*!
+		Address range covering buffers of retired allocators, readable without Mutex to free other buffers without lock (empty if none) */
+		static std::atomic<const char*>& RetiredBegin() { static std::atomic<const char*> Begin(nullptr); return Begin; }
+		static std::atomic<const char*>& RetiredEnd() { static std::atomic<const char*> End(nullptr); return End; }
+		static void Retire(Unique<Allocator>& pAllocator);
+		static void UpdateRetired(); // to call under Mutex
+		static bool FreeRetired(char* buffer, uint32_t size);
+
 	};
+protected:
+	/*!
+	Reference an external memory area which has to stay valid until the buffer deletion (see RingBuffer),
+	data are moved in an allocated buffer on a resize beyond size */
+	Buffer(uint32_t size, char* data, bool external);
+
 private:
 	Buffer(uint32_t size, char* buffer);
 
+	bool					_external;
 	uint32_t				_offset;
 	char*				_data;
 	uint32_t				_size;
@@ -15,6 +15,13 @@ details (or else see http://mozilla.org/MPL/2.0/).
 */
 
 #include "Mona/Memory/BufferPool.h"
+#include "Mona/Logs/Logs.h"
+#include <algorithm>
+#include <set>
+#if defined(__linux__)
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif
 
 
 using namespace std;
@@ -22,6 +29,326 @@ using namespace std;
 
 namespace Mona {
 
+atomic<uint32_t> BufferPool::_Ids(0);
+
+/*!
+Ids of alive pools, a pool is removed before its deletion, lock order is PoolsMutex then BufferPool::_mutex */
+static mutex& PoolsMutex() { static mutex Mutex; return Mutex; }
+static set<uint32_t>& Pools() { static set<uint32_t> Pools; return Pools; }
+
+/*!
+Capacity of the tier holding buffers of capacity bytes, rounded up as Buffer::Allocator::Alloc does (16B minimum), 0 if greater than 2GB */
+static uint32_t TierCapacity(uint32_t capacity) {
+	if (capacity <= 16)
+		return 16;
+	--capacity;
+	capacity |= capacity >> 1;
+	capacity |= capacity >> 2;
+	capacity |= capacity >> 4;
+	capacity |= capacity >> 8;
+	capacity |= capacity >> 16;
+	return ++capacity;
+}
+
+struct BufferPool::Cache : virtual Object {
+	/*!
+	Return the thread cache of pool, or NULL if the thread is exiting (cache already released) */
+	static Cache* Get(BufferPool& pool) {
+		static thread_local bool Released(false); // trivially destructible, stays readable after Cache destruction
+		static thread_local struct Holder : Cache {
+			~Holder() { Released = true; }
+		} Cache;
+		if (Released)
+			return NULL;
+		if (Cache._id != pool._id)
+			Cache.reset(pool); // cache of a previous pool
+		return &Cache;
+	}
+
+	std::atomic<uint8_t>	sizes[CACHE_TIERS]; // written just by the thread owner
+	char*				buffers[CACHE_TIERS][CACHE_MAX];
+	// statistics
+	Counter				pops[CACHE_TIERS];
+	Counter				pushes[CACHE_TIERS];
+	Counter				misses[CACHE_TIERS];
+
+protected:
+	Cache() : _pPool(NULL), _id(0) {
+		for (std::atomic<uint8_t>& size : sizes)
+			size = 0;
+	}
+	~Cache() { detach(); } // thread exit
+private:
+	void reset(BufferPool& pool) {
+		detach();
+		for (uint8_t i = 0; i < CACHE_TIERS; ++i) {
+			pops[i].store(0, memory_order_relaxed);
+			pushes[i].store(0, memory_order_relaxed);
+			misses[i].store(0, memory_order_relaxed);
+		}
+		_pPool = &pool;
+		_id = pool._id;
+		lock_guard<mutex> lock(pool._mutex);
+		pool._caches.emplace_back(this);
+	}
+	/*!
+	Give back buffers and statistics to the pool if it is still alive, and unregister from it */
+	void detach() {
+		if (!_pPool)
+			return;
+		lock_guard<mutex> lockPools(PoolsMutex()); // pool can't be deleted meanwhile
+		if (!Pools().count(_id)) {
+			clear(); // pool deleted
+			_pPool = NULL;
+			return;
+		}
+		uint8_t nodes[CACHE_MAX];
+		for (uint8_t i = 0; i < CACHE_TIERS; ++i) {
+			_pPool->nodesOf(buffers[i], sizes[i], nodes);
+			uint32_t rejects;
+			{
+				lock_guard<mutex> lock(_pPool->_mutex);
+				rejects = _pPool->push(i, buffers[i], sizes[i], nodes);
+				sizes[i] = 0;
+			}
+			while (rejects)
+				delete[] buffers[i][--rejects];
+		}
+		lock_guard<mutex> lock(_pPool->_mutex);
+		for (uint8_t i = 0; i < CACHE_TIERS; ++i) {
+			Buffers& buffers(_pPool->shared(0, i));
+			buffers.pops += pops[i]();
+			buffers.pushes += pushes[i]();
+			buffers.misses += misses[i]();
+		}
+		_pPool->_caches.erase(find(_pPool->_caches.begin(), _pPool->_caches.end(), this));
+		_pPool = NULL;
+	}
+	void clear() {
+		for (uint8_t i = 0; i < CACHE_TIERS; ++i) {
+			for (uint8_t j = 0; j < sizes[i]; ++j)
+				delete[] buffers[i][j];
+			sizes[i] = 0;
+		}
+	}
+
+	BufferPool*	_pPool;
+	uint32_t		_id;
+};
+
+static uint8_t NodeCount() {
+#if defined(__linux__)
+	// possible nodes, "0" or "0-3" for example
+	FILE* pFile = fopen("/sys/devices/system/node/possible", "r");
+	if (!pFile)
+		return 1;
+	uint32_t first(0), last(0);
+	int count = fscanf(pFile, "%u-%u", &first, &last);
+	fclose(pFile);
+	if (count == 2 && last < 0xFF)
+		return uint8_t(last + 1);
+#endif
+	return 1;
+}
+
+BufferPool::BufferPool(uint8_t cache, bool numa) : _id(++_Ids), _nodes(numa ? NodeCount() : 1), _bytes(0), _maxBytes(0xFFFFFFFFFFFFFFFF), _sweepInterval(10000) {
+	_buffers = Unique<Buffers[]>(new Buffers[_nodes * 28]);
+	for (uint8_t i = 0; i < CACHE_TIERS; ++i)
+		_cache[i] = uint8_t(min(cache, uint32_t(CACHE_MAX), max(uint32_t(CACHE_BYTES >> (i + 4)), 2u)));
+	{
+		lock_guard<mutex> lock(PoolsMutex());
+		Pools().emplace(_id);
+	}
+	start(Thread::PRIORITY_LOWEST);
+}
+
+BufferPool::~BufferPool() {
+	stop();
+	// thread caches still registered release their buffers themselves on their next use or on thread exit
+	lock_guard<mutex> lock(PoolsMutex());
+	Pools().erase(_id);
+}
+
+char* BufferPool::alloc(uint32_t& capacity) {
+	uint8_t index = computeIndex(capacity);
+	Cache* pCache = index < CACHE_TIERS && _cache[index] ? Cache::Get(self) : NULL;
+	if (pCache) {
+		uint8_t size = pCache->sizes[index].load(memory_order_relaxed);
+		if (!size) {
+			// refill the half of the thread cache
+			uint8_t node = currentNode();
+			lock_guard<mutex> lock(_mutex);
+			size = uint8_t(shared(node, index).pop(pCache->buffers[index], (_cache[index] + 1) / 2));
+			_bytes -= uint64_t(size) << (index + 4);
+		}
+		if (!size) {
+			++pCache->misses[index];
+			return new char[capacity];
+		}
+		++pCache->pops[index];
+		pCache->sizes[index].store(--size, memory_order_relaxed);
+		return pCache->buffers[index][size];
+	}
+	char* buffer;
+	uint8_t node = currentNode();
+	{
+		lock_guard<mutex> lock(_mutex);
+		Buffers& buffers(shared(node, index));
+		if ((buffer = buffers.pop())) {
+			_bytes -= capacity;
+			++buffers.pops;
+		} else
+			++buffers.misses;
+	}
+	return buffer ? buffer : new char[capacity];
+}
+
+void BufferPool::free(char* buffer, uint32_t capacity) {
+	uint8_t index = computeIndex(capacity);
+	Cache* pCache = index < CACHE_TIERS && _cache[index] ? Cache::Get(self) : NULL;
+	if (!pCache) {
+		uint8_t node;
+		nodesOf(&buffer, 1, &node);
+		{
+			lock_guard<mutex> lock(_mutex);
+			++shared(node, index).pushes;
+			if (!push(index, &buffer, 1, &node))
+				return;
+		}
+		return delete[] buffer; // rejected
+	}
+	uint8_t size = pCache->sizes[index].load(memory_order_relaxed);
+	if (size == _cache[index]) {
+		// flush the older half of the thread cache (keep the more recent buffers, hot in CPU cache)
+		uint8_t count = (size + 1) / 2, nodes[CACHE_MAX];
+		nodesOf(pCache->buffers[index], count, nodes);
+		uint32_t rejects;
+		{
+			lock_guard<mutex> lock(_mutex);
+			rejects = push(index, pCache->buffers[index], count, nodes);
+		}
+		while (rejects)
+			delete[] pCache->buffers[index][--rejects];
+		memmove(pCache->buffers[index], pCache->buffers[index] + count, (size -= count) * sizeof(char*));
+	}
+	pCache->buffers[index][size] = buffer;
+	pCache->sizes[index].store(++size, memory_order_relaxed);
+	++pCache->pushes[index];
+}
+
+uint32_t BufferPool::push(uint8_t index, char** buffers, uint32_t count, const uint8_t* nodes) {
+	uint64_t capacity = 16ull << index, maxBytes = _maxBytes.load(memory_order_relaxed);
+	uint32_t rejects(0);
+	for (uint32_t i = 0; i < count; ++i) {
+		Buffers& tier(shared(nodes[i], index));
+		if (tier.size() >= tier.maxSize || (_bytes + capacity) > maxBytes) {
+			++tier.rejects;
+			buffers[rejects++] = buffers[i];
+			continue;
+		}
+		tier.push(buffers[i]);
+		_bytes += capacity;
+	}
+	return rejects;
+}
+
+void BufferPool::nodesOf(char** buffers, uint32_t count, uint8_t* nodes) const {
+	DEBUG_ASSERT(count <= CACHE_MAX);
+	if (_nodes > 1) {
+#if defined(SYS_move_pages)
+		// move_pages without target nodes returns the node of every page
+		void* pages[CACHE_MAX];
+		int status[CACHE_MAX];
+		uintptr_t mask = ~uintptr_t(sysconf(_SC_PAGESIZE) - 1);
+		for (uint32_t i = 0; i < count; ++i)
+			pages[i] = (void*)(uintptr_t(buffers[i]) & mask);
+		if (syscall(SYS_move_pages, 0, count, pages, NULL, status, 0) == 0) {
+			uint8_t node(0xFF);
+			for (uint32_t i = 0; i < count; ++i) {
+				if (status[i] >= 0 && status[i] < _nodes)
+					nodes[i] = uint8_t(status[i]);
+				else // page not yet touched
+					nodes[i] = node == 0xFF ? (node = currentNode()) : node;
+			}
+			return;
+		}
+#endif
+		memset(nodes, currentNode(), count);
+	} else
+		memset(nodes, 0, count);
+}
+
+uint8_t BufferPool::currentNode() const {
+#if defined(SYS_getcpu)
+	if (_nodes > 1) {
+		unsigned cpu, node;
+		if (syscall(SYS_getcpu, &cpu, &node, NULL) == 0 && node < _nodes)
+			return uint8_t(node);
+	}
+#endif
+	return 0;
+}
+
+uint32_t BufferPool::maxBuffers(uint32_t capacity) const {
+	if (!(capacity = TierCapacity(capacity)))
+		return 0; // no tier, never held
+	lock_guard<mutex> lock(_mutex);
+	return _buffers[computeIndex(capacity)].maxSize;
+}
+
+BufferPool& BufferPool::setMaxBuffers(uint32_t capacity, uint32_t count) {
+	if (!(capacity = TierCapacity(capacity)))
+		return self; // no tier
+	uint8_t index = computeIndex(capacity);
+	lock_guard<mutex> lock(_mutex);
+	for (uint8_t node = 0; node < _nodes; ++node)
+		shared(node, index).maxSize = count;
+	return self;
+}
+
+vector<BufferPool::Stats>& BufferPool::stats(vector<BufferPool::Stats>& stats) const {
+	stats.clear();
+	stats.reserve(28);
+	lock_guard<mutex> lock(_mutex);
+	for (uint8_t i = 0; i < 28; ++i) {
+		stats.emplace_back(16u << i);
+		Stats& tier(stats.back());
+		for (uint8_t node = 0; node < _nodes; ++node) {
+			const Buffers& buffers(_buffers[node * 28 + i]);
+			tier.pops += buffers.pops;
+			tier.pushes += buffers.pushes;
+			tier.misses += buffers.misses;
+			tier.evictions += buffers.evictions;
+			tier.rejects += buffers.rejects;
+			tier.held += buffers.size();
+			tier.highWater += buffers.highWater;
+		}
+		if (i >= CACHE_TIERS)
+			continue;
+		for (const Cache* pCache : _caches) {
+			tier.pops += pCache->pops[i]();
+			tier.pushes += pCache->pushes[i]();
+			tier.misses += pCache->misses[i]();
+			tier.held += pCache->sizes[i].load(memory_order_relaxed);
+		}
+	}
+	return stats;
+}
+
+void BufferPool::log(LOG_LEVEL level) const {
+	vector<Stats> tiers;
+	uint64_t bytes(0);
+	for (const Stats& tier : stats(tiers)) {
+		if (!tier.pops && !tier.misses && !tier.pushes)
+			continue; // unused
+		LOG(level, "BufferPool ", tier.capacity, "B, ", tier.pops, " pops, ", tier.pushes, " pushes, ", tier.misses, " misses (",
+			String::Format<double>("%.1f", tier.hitRate()), "% hit), ", tier.held, " held (", tier.bytes(), "B), ",
+			tier.highWater, " high-water, ", tier.evictions, " evictions, ", tier.rejects, " rejects");
+		bytes += tier.bytes();
+	}
+	LOG(level, "BufferPool holds ", bytes, "B");
+}
+
 char* BufferPool::Buffers::pop() {
 	if (empty())
 		return NULL;
@@ -31,16 +358,26 @@ char* BufferPool::Buffers::pop() {
 		_minSize = size();
 	return buffer;
 }
+uint32_t BufferPool::Buffers::pop(char** buffers, uint32_t count) {
+	if (count > size())
+		count = size();
+	memcpy(buffers, data() + size() - count, count * sizeof(char*));
+	resize(size() - count);
+	if (size() < _minSize)
+		_minSize = size();
+	return count;
+}
 void BufferPool::Buffers::push(char* buffer) {
 	emplace_back(buffer);
-	if (size() > _maxSize)
-		_maxSize = size();
+	if (size() > _maxSize && (_maxSize = size()) > highWater)
+		highWater = _maxSize;
 }
 void BufferPool::Buffers::manage(vector<char*>& gc) {
 	// pickUp
 	uint32_t position = gc.size();
 	gc.resize(position + _minSize);
 	memcpy(gc.data() + position, data() + size() - _minSize, _minSize * sizeof(char*));
+	evictions += _minSize;
 	// reserve max capacity + remove erasing buffer + reset _minSize/_maxSize
 	_minSize = size() - _minSize;
 	resize(_maxSize);
@@ -50,25 +387,34 @@ void BufferPool::Buffers::manage(vector<char*>& gc) {
 }
 
 bool BufferPool::run(Exception& ex, const volatile bool& requestStop) {
-	uint16_t timeout = 10000;
+	Time time; // last sweep
 	while (!requestStop) {
-		if (timeout && wakeUp.wait(timeout)) // wait()==true means requestStop=true because there is no other wakeUp.set elsewhere
-			return true;
-		Time time;
-		for (Buffers& buffers : _buffers) {
+		uint32_t interval = _sweepInterval;
+		int64_t timeout = interval - time.elapsed();
+		if (!interval || timeout > 0) {
+			wakeUp.wait(uint32_t(max(timeout, int64_t(0)))); // wakeUp on stop or on sweep interval change
+			continue;
+		}
+		time.update();
+		uint64_t bytes(0);
+		for (uint16_t i = 0; i < _nodes * 28; ++i) {
 			vector<char*> gc;
-			Lock();
-			buffers.manage(gc); // garbage collector!
-			Unlock();
+			{
+				lock_guard<mutex> lock(_mutex);
+				_buffers[i].manage(gc); // garbage collector!
+				_bytes -= uint64_t(gc.size()) << (i % 28 + 4);
+			}
 			for (char* buffer : gc)
 				delete[] buffer;
+			bytes += uint64_t(gc.size()) << (i % 28 + 4);
 		}
-		timeout = (uint16_t)max(10000 - time.elapsed(), 0);
+		if (bytes)
+			DEBUG("BufferPool GC releases ", bytes, "B");
 	}
 	return true;
 }
 
-uint8_t BufferPool::computeIndex(uint32_t capacity) {
+uint8_t BufferPool::computeIndex(uint32_t capacity) const {
 	--capacity;
 	// compute index
 	capacity = (capacity << 3) - capacity;    // Multiply by 7.
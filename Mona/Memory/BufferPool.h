@@ -19,35 +19,141 @@ details (or else see http://mozilla.org/MPL/2.0/).
 #include "Mona/Mona.h"
 #include "Mona/Memory/Buffer.h"
 #include "Mona/Threading/Thread.h"
+#include "Mona/Logs/Logger.h"
 
 namespace Mona {
 
+/*!
+Buffer allocator which recycles buffers by power of two capacity tiers,
+each thread keeps a small cache of buffers by tier (until 64KB) to allocate/free without any lock,
+this cache is refilled/flushed by batch from/to the shared tiers.
+A GC thread releases on every sweep (10 seconds by default) the buffers which have not been used since the last sweep,
+and a memory budget or tier caps can bound the shared tiers: a buffer pushed beyond is released immediately.
+In NUMA mode shared tiers are duplicated by memory node: a buffer is given back to the tiers of the node holding its memory,
+and is reused by a thread running on this node (pin workers with ThreadPool affinity to get local buffers).
+Install it with Buffer::Allocator::Set<BufferPool>() which returns the instance to get its statistics */
 struct BufferPool : Buffer::Allocator, private Thread, virtual Object {
+	/*!
+	cache is the maximum number of buffers by tier in a thread cache, 0 disables thread caches,
+	numa enables shared tiers by memory node (ignored on single node system or on OS other than Linux) */
+	BufferPool(uint8_t cache = 32, bool numa = false);
+	~BufferPool();
 
-	BufferPool() { start(Thread::PRIORITY_LOWEST); }
-	~BufferPool() { stop(); }
+	struct Stats {
+		Stats(uint32_t capacity = 0) : capacity(capacity), pops(0), pushes(0), misses(0), evictions(0), rejects(0), held(0), highWater(0) {}
+
+		uint32_t	capacity;
+		uint64_t	pops; // allocations served by the pool
+		uint64_t	pushes; // buffers given back to the pool (rejects included)
+		uint64_t	misses; // allocations which have required a new buffer
+		uint64_t	evictions; // buffers released by the GC
+		uint64_t	rejects; // buffers released on push because of tier cap or memory budget
+		uint32_t	held; // buffers held now by the pool (shared tier + thread caches)
+		uint32_t	highWater; // maximum buffers held by the shared tier
+
+		uint64_t	bytes() const { return uint64_t(held) * capacity; }
+		double		hitRate() const { return (pops + misses) ? 100.0 * pops / (pops + misses) : 100; }
+	};
+	/*!
+	Snapshot of statistics, one entry by tier (from 16B to 2GB) */
+	std::vector<Stats>&	stats(std::vector<Stats>& stats) const;
+	/*!
+	Dump statistics of used tiers in logs */
+	void				log(LOG_LEVEL level = LOG_INFO) const;
+
+	/*!
+	Maximum bytes held by the shared tiers, 0xFFFFFFFFFFFFFFFF by default (no limit).
+	Thread caches are not included, they are already bounded to 256KB by tier and thread */
+	uint64_t			maxBytes() const { return _maxBytes; }
+	BufferPool&			setMaxBytes(uint64_t bytes) { _maxBytes = bytes; return self; }
+	/*!
+	Number of memory nodes with their own shared tiers, 1 if NUMA mode is disabled */
+	uint8_t				nodes() const { return _nodes; }
+	/*!
+	Maximum buffers held by the shared tier of capacity on every node, 0xFFFFFFFF by default (no limit).
+	capacity is rounded up to the tier like an allocation (power of two from 16B to 2GB), beyond 2GB there is no tier to limit */
+	uint32_t			maxBuffers(uint32_t capacity) const;
+	BufferPool&			setMaxBuffers(uint32_t capacity, uint32_t count);
+	/*!
+	Interval between two GC sweeps in milliseconds, 10000 by default, 0 disables GC */
+	uint32_t			sweepInterval() const { return _sweepInterval; }
+	BufferPool&			setSweepInterval(uint32_t milliseconds) { _sweepInterval = milliseconds; wakeUp.set(); return self; }
+	/*!
+	Placement of the GC thread (see Thread), applied on next start of GC */
+	using Thread::affinity;
+	using Thread::setAffinity;
+	using Thread::realTime;
+	using Thread::setRealTime;
+	using Thread::placement;
+
+protected:
+	char* alloc(uint32_t& capacity) override;
+	void  free(char* buffer, uint32_t capacity) override;
+	/*!
+	Tier index of capacity (power of two from 16B to 2GB) */
+	uint8_t computeIndex(uint32_t capacity) const;
 
 private:
-	char* alloc(uint32_t& capacity) override {
-		char* buffer = _buffers[computeIndex(capacity)].pop();
-		return buffer ? buffer : new char[capacity];
-	}
-	void free(char* buffer, uint32_t capacity) override { _buffers[computeIndex(capacity)].push(buffer); }
+	bool  concurrent() const override { return true; }
 
 	bool run(Exception& ex, const volatile bool& requestStop);
-	uint8_t computeIndex(uint32_t capacity);
+	/*!
+	Push buffers in the shared tier index of their node in the limit of its cap and of memory budget, to call under _mutex.
+	Returns the count of buffers rejected, moved at the beginning of buffers, the caller has to release them */
+	uint32_t push(uint8_t index, char** buffers, uint32_t count, const uint8_t* nodes);
+	/*!
+	Memory nodes of buffers (current node for a buffer without memory yet), to call without _mutex because it can make a system call */
+	void	 nodesOf(char** buffers, uint32_t count, uint8_t* nodes) const;
+	uint8_t  currentNode() const;
+
+	enum {
+		CACHE_TIERS = 13, // tiers cached by thread, until 64KB
+		CACHE_MAX = 64, // maximum buffers by tier in a thread cache
+		CACHE_BYTES = 0x40000 // maximum bytes by tier in a thread cache (256KB), limits the number of big buffers cached
+	};
+	/*!
+	Counter written by one thread at a time (thread cache owner), readable from any thread */
+	struct Counter : std::atomic<uint64_t> {
+		Counter() : std::atomic<uint64_t>(0) {}
+		Counter& operator++() { store(load(std::memory_order_relaxed) + 1, std::memory_order_relaxed); return self; }
+		uint64_t operator()() const { return load(std::memory_order_relaxed); }
+	};
+	struct Cache;
 
 	struct Buffers : private std::vector<char*>, virtual Object {
-		Buffers() : _minSize(0), _maxSize(0) {}
+		Buffers() : maxSize(0xFFFFFFFF), pops(0), pushes(0), misses(0), evictions(0), rejects(0), highWater(0), _minSize(0), _maxSize(0) {}
 		~Buffers() { for (char* buffer : self) delete[] buffer; }
+		uint32_t	size() const { return std::vector<char*>::size(); }
 		char*	pop();
+		uint32_t	pop(char** buffers, uint32_t count);
 		void   push(char* buffer);
 		void	manage(std::vector<char*>& gc);
+
+		uint32_t maxSize; // tier cap, protected by _mutex
+		// statistics of shared tier + thread caches released, protected by _mutex
+		uint64_t pops;
+		uint64_t pushes;
+		uint64_t misses;
+		uint64_t evictions;
+		uint64_t rejects;
+		uint32_t highWater;
 	private:
 		uint32_t _minSize;
 		uint32_t _maxSize;
 	};
-	Buffers			 _buffers[28];
+	Buffers& shared(uint8_t node, uint8_t index) { return _buffers[node * 28 + index]; }
+
+	Unique<Buffers[]>	 _buffers; // 28 tiers by node
+	std::vector<Cache*>	 _caches;
+	uint64_t			 _bytes; // bytes held by _buffers, protected by _mutex
+	mutable std::mutex	 _mutex; // protect _buffers, _bytes and _caches
+	std::atomic<uint64_t> _maxBytes;
+	std::atomic<uint32_t> _sweepInterval;
+	uint8_t				 _cache[CACHE_TIERS];
+	const uint32_t		 _id;
+	const uint8_t		 _nodes;
+
+	static std::atomic<uint32_t> _Ids; // pool id generator, a thread cache checks by id that its pool is still alive (see Cache)
 };
 
 
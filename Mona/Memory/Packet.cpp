@@ -16,6 +16,19 @@ details (or else see http://mozilla.org/MPL/2.0/).
 
 #include "Mona/Memory/Packet.h"
 #include "Mona/Util/Exceptions.h"
+#if defined(__x86_64__) || defined(_M_X64)
+	#define SIMD_SSE2
+	#include <immintrin.h>
+	#if defined(_MSC_VER)
+		#include <intrin.h>
+		#define TARGET_AVX2
+	#else
+		#define TARGET_AVX2 __attribute__((target("avx2")))
+	#endif
+#elif defined(__aarch64__)
+	#define SIMD_NEON
+	#include <arm_neon.h>
+#endif
 
 using namespace std;
 
@@ -24,16 +37,128 @@ namespace Mona {
 
 const Shared<const Bytes> Packet::_NullBytes;
 
-uint32_t Packet::identicalBytes(const Packet& packet) const {
-	uint32_t size = min(_size, packet._size);
-	uint32_t i;
-	for (i = 0; i < size; ++i) {
-		if (_data[i] != packet._data[i])
+static uint32_t IdenticalBytesScalar(const uint8_t* data1, const uint8_t* data2, uint32_t size) {
+	uint32_t i = 0;
+	// word by word, then byte by byte to find the first mismatch
+	for (uint64_t word1, word2; (i + 8) <= size; i += 8) {
+		memcpy(&word1, data1 + i, 8);
+		memcpy(&word2, data2 + i, 8);
+		if (word1 != word2)
 			break;
 	}
+	while (i < size && data1[i] == data2[i])
+		++i;
 	return i;
 }
 
+#if defined(SIMD_SSE2)
+static uint32_t FirstBit(uint32_t mask) {
+#if defined(_MSC_VER)
+	unsigned long index;
+	_BitScanForward(&index, mask);
+	return index;
+#else
+	return __builtin_ctz(mask);
+#endif
+}
+
+static uint32_t IdenticalBytesSSE2(const uint8_t* data1, const uint8_t* data2, uint32_t size) {
+	uint32_t i = 0;
+	// equality fast path by 64 bytes: one test for 4 comparisons
+	for (; (i + 64) <= size; i += 64) {
+		__m128i eq0 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(data1 + i)), _mm_loadu_si128((const __m128i*)(data2 + i)));
+		__m128i eq1 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(data1 + i + 16)), _mm_loadu_si128((const __m128i*)(data2 + i + 16)));
+		__m128i eq2 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(data1 + i + 32)), _mm_loadu_si128((const __m128i*)(data2 + i + 32)));
+		__m128i eq3 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(data1 + i + 48)), _mm_loadu_si128((const __m128i*)(data2 + i + 48)));
+		if (_mm_movemask_epi8(_mm_and_si128(_mm_and_si128(eq0, eq1), _mm_and_si128(eq2, eq3))) != 0xFFFF)
+			break; // mismatch located by the loop below
+	}
+	for (; (i + 16) <= size; i += 16) {
+		uint32_t mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(data1 + i)), _mm_loadu_si128((const __m128i*)(data2 + i))));
+		if (mask != 0xFFFF)
+			return i + FirstBit(~mask);
+	}
+	return i + IdenticalBytesScalar(data1 + i, data2 + i, size - i);
+}
+
+TARGET_AVX2 static uint32_t IdenticalBytesAVX2(const uint8_t* data1, const uint8_t* data2, uint32_t size) {
+	uint32_t i = 0;
+	// equality fast path by 128 bytes: one test for 4 comparisons
+	for (; (i + 128) <= size; i += 128) {
+		__m256i eq0 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(data1 + i)), _mm256_loadu_si256((const __m256i*)(data2 + i)));
+		__m256i eq1 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(data1 + i + 32)), _mm256_loadu_si256((const __m256i*)(data2 + i + 32)));
+		__m256i eq2 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(data1 + i + 64)), _mm256_loadu_si256((const __m256i*)(data2 + i + 64)));
+		__m256i eq3 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(data1 + i + 96)), _mm256_loadu_si256((const __m256i*)(data2 + i + 96)));
+		if (uint32_t(_mm256_movemask_epi8(_mm256_and_si256(_mm256_and_si256(eq0, eq1), _mm256_and_si256(eq2, eq3)))) != 0xFFFFFFFF)
+			break; // mismatch located by the loop below
+	}
+	for (; (i + 32) <= size; i += 32) {
+		uint32_t mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(data1 + i)), _mm256_loadu_si256((const __m256i*)(data2 + i))));
+		if (mask != 0xFFFFFFFF)
+			return i + FirstBit(~mask);
+	}
+	return i + IdenticalBytesSSE2(data1 + i, data2 + i, size - i);
+}
+
+static bool HasAVX2() {
+#if defined(_MSC_VER)
+	int infos[4];
+	__cpuid(infos, 0);
+	if (infos[0] < 7)
+		return false;
+	__cpuid(infos, 1);
+	if ((infos[2] & 0x18000000) != 0x18000000 || (_xgetbv(0) & 6) != 6) // OSXSAVE+AVX and YMM state enabled by OS
+		return false;
+	__cpuidex(infos, 7, 0);
+	return (infos[1] & 0x20) ? true : false;
+#else
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx2");
+#endif
+}
+#elif defined(SIMD_NEON)
+static uint32_t IdenticalBytesNEON(const uint8_t* data1, const uint8_t* data2, uint32_t size) {
+	uint32_t i = 0;
+	// equality fast path by 64 bytes: one test for 4 comparisons
+	for (; (i + 64) <= size; i += 64) {
+		uint8x16_t eq0 = vceqq_u8(vld1q_u8(data1 + i), vld1q_u8(data2 + i));
+		uint8x16_t eq1 = vceqq_u8(vld1q_u8(data1 + i + 16), vld1q_u8(data2 + i + 16));
+		uint8x16_t eq2 = vceqq_u8(vld1q_u8(data1 + i + 32), vld1q_u8(data2 + i + 32));
+		uint8x16_t eq3 = vceqq_u8(vld1q_u8(data1 + i + 48), vld1q_u8(data2 + i + 48));
+		if (vminvq_u8(vandq_u8(vandq_u8(eq0, eq1), vandq_u8(eq2, eq3))) != 0xFF)
+			break; // mismatch located by the loop below
+	}
+	for (; (i + 16) <= size; i += 16) {
+		// narrow 0xFF/0x00 bytes to 4 bits by byte, the first zero nibble gives the mismatch
+		uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(vceqq_u8(vld1q_u8(data1 + i), vld1q_u8(data2 + i))), 4)), 0);
+		if (mask != 0xFFFFFFFFFFFFFFFF)
+			return i + (__builtin_ctzll(~mask) >> 2);
+	}
+	return i + IdenticalBytesScalar(data1 + i, data2 + i, size - i);
+}
+#endif
+
+typedef uint32_t (*IdenticalBytesKernel)(const uint8_t*, const uint8_t*, uint32_t);
+/*!
+Kernel selected once according to CPU features, on first call to be valid even from a static initializer of an other translation unit */
+static IdenticalBytesKernel IdenticalBytes() {
+#if defined(SIMD_SSE2)
+	static const IdenticalBytesKernel Kernel(HasAVX2() ? IdenticalBytesAVX2 : IdenticalBytesSSE2);
+	return Kernel;
+#elif defined(SIMD_NEON)
+	return IdenticalBytesNEON;
+#else
+	return IdenticalBytesScalar;
+#endif
+}
+
+uint32_t Packet::identicalBytes(const Packet& packet) const {
+	uint32_t size = min(_size, packet._size);
+	if (_data == packet._data)
+		return size; // same data (shared buffer)
+	return IdenticalBytes()((const uint8_t*)_data, (const uint8_t*)packet._data, size);
+}
+
 Packet& Packet::operator+=(uint32_t offset) {
 	if (offset>_size)
 		offset = _size;
@@ -106,15 +106,18 @@ struct Packet: Bytes, virtual Object {
 	virtual ~Packet() { if (!_reference) delete _ppBuffer; }
 	/*!
 	Allow to compare data packet*/
-	bool operator == (const Packet& packet) const { return _size == packet._size && (!_size || memcmp(_data, packet._data, _size)==0); }
+	bool operator == (const Packet& packet) const { return _size == packet._size && (!_size || _data == packet._data || memcmp(_data, packet._data, _size)==0); }
 	bool operator != (const Packet& packet) const { return !operator==(packet); }
-	bool operator <  (const Packet& packet) const { return _size != packet._size ? _size < packet._size : (_size && memcmp(_data, packet._data, _size) < 0); }
-	bool operator <= (const Packet& packet) const { return operator==(packet) || operator<(packet); }
-	bool operator >  (const Packet& packet) const { return !operator<=(packet); }
-	bool operator >= (const Packet& packet) const { return operator==(packet) || operator>(packet); }
+	bool operator <  (const Packet& packet) const { return compare(packet) < 0; }
+	bool operator <= (const Packet& packet) const { return compare(packet) <= 0; }
+	bool operator >  (const Packet& packet) const { return compare(packet) > 0; }
+	bool operator >= (const Packet& packet) const { return compare(packet) >= 0; }
+	/*!
+	Compare size then data, returns a negative value if this packet is inferior, 0 if equal, a positive value if superior */
+	int	 compare(const Packet& packet) const { return _size != packet._size ? (_size < packet._size ? -1 : 1) : ((!_size || _data == packet._data) ? 0 : memcmp(_data, packet._data, _size)); }
 
 	/*!
-	Return number of identical bytes */
+	Return number of identical bytes (SIMD comparison, with AVX2 or SSE2 according to CPU on x86-64 and NEON on ARM64) */
 	uint32_t identicalBytes(const Packet& packet) const;
 	/*!
 	Return buffer */
@@ -0,0 +1,78 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#include "Mona/Memory/PacketList.h"
+
+using namespace std;
+
+
+namespace Mona {
+
+PacketList& PacketList::append(const Packet& packet) {
+	if (packet) {
+		_packets.emplace_back(packet);
+		_size += packet.size();
+	}
+	return self;
+}
+
+PacketList& PacketList::append(const Packet&& packet) {
+	if (packet) {
+		_packets.emplace_back(move(packet));
+		_size += packet.size();
+	}
+	return self;
+}
+
+PacketList& PacketList::prepend(const Packet& packet) {
+	if (packet) {
+		_packets.emplace_front(packet);
+		_size += packet.size();
+	}
+	return self;
+}
+
+PacketList& PacketList::prepend(const Packet&& packet) {
+	if (packet) {
+		_packets.emplace_front(move(packet));
+		_size += packet.size();
+	}
+	return self;
+}
+
+PacketList& PacketList::operator+=(uint32_t offset) {
+	if (offset >= _size)
+		return clear();
+	_size -= offset;
+	while (offset >= _packets.front().size()) {
+		offset -= _packets.front().size();
+		_packets.pop_front();
+	}
+	_packets.front() += offset;
+	return self;
+}
+
+char* PacketList::copy(char* data) const {
+	char* current(data);
+	for (const Packet& packet : _packets) {
+		memcpy(current, packet.data(), packet.size());
+		current += packet.size();
+	}
+	return data;
+}
+
+
+} // namespace Mona
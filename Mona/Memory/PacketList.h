@@ -0,0 +1,87 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#pragma once
+
+#include "Mona/Mona.h"
+#include "Mona/Memory/Packet.h"
+#include <deque>
+
+namespace Mona {
+
+/*!
+PacketList is a scatter/gather list of packets, to send or write an area of data in several parts without copying them in a contiguous buffer,
+typically to prepend a protocol header to a payload. Packets are referenced or bufferized with the same rules as Packet:
+	PacketList packets;
+	packets.append(std::move(pPayload)); // capture and share the payload buffer
+	packets.prepend(std::move(pHeader)); // capture and share the header buffer, payload is not moved or copied
+	pSocket->write(ex, packets); // one system call (sendmsg/writev) */
+struct PacketList : virtual Object {
+	NULLABLE(!_size)
+
+	typedef std::deque<Packet>::const_iterator const_iterator;
+
+	PacketList() : _size(0) {}
+	/*!
+	Reference packets of list (explicit to not reference a temporary list) */
+	explicit PacketList(const PacketList& packets) : _size(0) { for (const Packet& packet : packets) append(packet); }
+	/*!
+	Bufferize packets of list */
+	PacketList(const PacketList&& packets) : _size(0) { for (const Packet& packet : packets) append(std::move(packet)); }
+	/*!
+	Bufferize packet in a new list */
+	PacketList(const Packet&& packet) : _size(0) { append(std::move(packet)); }
+
+	/*!
+	Total size of packets */
+	uint32_t		size() const { return _size; }
+	/*!
+	Number of packets */
+	uint32_t		count() const { return _packets.size(); }
+
+	const_iterator	begin() const { return _packets.begin(); }
+	const_iterator	end() const { return _packets.end(); }
+	const Packet&	front() const { return _packets.front(); }
+	const Packet&	back() const { return _packets.back(); }
+	const Packet&	operator[](uint32_t i) const { DEBUG_ASSERT(i < _packets.size()) return _packets[i]; }
+
+	/*!
+	Reference packet at the end of the list (explicit reference, packet must stay alive while the list is used) */
+	PacketList&		append(const Packet& packet);
+	/*!
+	Bufferize packet at the end of the list */
+	PacketList&		append(const Packet&& packet);
+	/*!
+	Reference packet at the beginning of the list (explicit reference, packet must stay alive while the list is used) */
+	PacketList&		prepend(const Packet& packet);
+	/*!
+	Bufferize packet at the beginning of the list */
+	PacketList&		prepend(const Packet&& packet);
+	/*!
+	Move the beginning of the list of offset bytes, useful after a partial sending */
+	PacketList&		operator+=(uint32_t offset);
+	PacketList&		clear() { _packets.clear(); _size = 0; return self; }
+	/*!
+	Copy packets in data which must be able to contain size() bytes, returns data */
+	char*			copy(char* data) const;
+
+private:
+	std::deque<Packet>	_packets;
+	uint32_t			_size;
+};
+
+
+} // namespace Mona
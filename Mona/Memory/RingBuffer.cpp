@@ -0,0 +1,118 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#include "Mona/Memory/RingBuffer.h"
+#include "Mona/Memory/Slab.h"
+#include "Mona/Logs/Logs.h"
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+
+using namespace std;
+
+
+namespace Mona {
+
+struct RingBuffer::View : Buffer, virtual Object {
+	View(const Shared<RingBuffer>& pRing, char* data, uint32_t size) : Buffer(size, data, true), _pRing(pRing), _begin(pRing->_head - size), _end(pRing->_head) {}
+	~View() { _pRing->release(_begin, _end); }
+private:
+	Shared<RingBuffer>	_pRing;
+	uint64_t				_begin;
+	uint64_t				_end;
+};
+
+RingBuffer::RingBuffer(uint32_t capacity) : _data(NULL), _mirrored(false), _head(0), _tail(0) {
+#if defined(_WIN32)
+	SYSTEM_INFO infos;
+	GetSystemInfo(&infos);
+	uint32_t page = infos.dwAllocationGranularity;
+#else
+	uint32_t page = sysconf(_SC_PAGESIZE);
+#endif
+	_capacity = capacity ? ((capacity + page - 1) / page * page) : page;
+#if defined(SYS_memfd_create)
+	int fd = syscall(SYS_memfd_create, "RingBuffer", 0);
+	if (fd >= 0) {
+		// reserve two times the capacity, and map the same memory in the both halves
+		void* mapping = ftruncate(fd, _capacity) ? MAP_FAILED : mmap(NULL, _capacity * 2ull, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (mapping != MAP_FAILED) {
+			if (mmap(mapping, _capacity, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) != MAP_FAILED &&
+				mmap((char*)mapping + _capacity, _capacity, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) != MAP_FAILED) {
+				_data = (char*)mapping;
+				_mirrored = true;
+			} else
+				munmap(mapping, _capacity * 2ull);
+		}
+		::close(fd);
+	}
+	if (!_mirrored)
+		WARN("RingBuffer without mirror mapping, ", strerror(errno));
+#endif
+	if (!_data)
+		_data = new char[_capacity];
+}
+
+RingBuffer::~RingBuffer() {
+#if !defined(_WIN32)
+	if (_mirrored) {
+		munmap(_data, _capacity * 2ull);
+		return;
+	}
+#endif
+	delete[] _data;
+}
+
+char* RingBuffer::write(uint32_t& size) const {
+	uint32_t position = uint32_t(_head % _capacity);
+	size = _capacity - uint32_t(_head - _tail.load(memory_order_acquire));
+	if (!_mirrored && size > (_capacity - position))
+		size = _capacity - position; // stop on the end of the ring
+	return size ? (_data + position) : NULL;
+}
+
+Shared<Buffer> RingBuffer::Commit(const Shared<RingBuffer>& pRing, uint32_t size) {
+	DEBUG_ASSERT(size <= pRing->_capacity - pRing->size());
+	char* data = pRing->_data + pRing->_head % pRing->_capacity;
+	pRing->_head += size;
+	return allocate_shared<View>(SlabAllocator<View>(), pRing, data, size);
+}
+
+void RingBuffer::release(uint64_t begin, uint64_t end) {
+	if (begin == end)
+		return; // empty view
+	lock_guard<mutex> lock(_mutex);
+	if (begin != _tail.load(memory_order_relaxed)) {
+		// an older view is always alive
+		_released.emplace(begin, end);
+		return;
+	}
+	// move forward on views released before
+	auto it = _released.begin();
+	while (it != _released.end() && it->first == end) {
+		end = it->second;
+		it = _released.erase(it);
+	}
+	_tail.store(end, memory_order_release);
+}
+
+
+} // namespace Mona
@@ -0,0 +1,68 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#pragma once
+
+#include "Mona/Mona.h"
+#include "Mona/Memory/Buffer.h"
+#include <map>
+#include <mutex>
+
+namespace Mona {
+
+/*!
+RingBuffer is a contiguous memory area written in loop by one writer (typically a receiving socket),
+written data are given as Buffer views without copy or allocation, and every view gives back its area on deletion
+(views can be released in any order, the ring moves forward on the oldest one).
+On Linux the area is mapped twice in a row (memfd + double mmap) to get always a contiguous writable area even on the end of the ring,
+elsewhere the writable area stops on the end of the ring. A view resized beyond its size moves its data in an allocated buffer */
+struct RingBuffer : virtual Object {
+	/*!
+	capacity is rounded up to page size */
+	RingBuffer(uint32_t capacity);
+	~RingBuffer();
+
+	uint32_t		capacity() const { return _capacity; }
+	/*!
+	Bytes held by views not released yet */
+	uint32_t		size() const { return uint32_t(_head - _tail.load(std::memory_order_acquire)); }
+	/*!
+	True if the area is mirror-mapped (writable area never cut by the end of the ring) */
+	bool		mirrored() const { return _mirrored; }
+
+	/*!
+	Returns the writable area and assigns its size, or NULL if the ring is full, to call by the writer thread only */
+	char*		write(uint32_t& size) const;
+	/*!
+	Returns a view on the size bytes written in the area given by the last write call, and moves the writable area after */
+	static Shared<Buffer> Commit(const Shared<RingBuffer>& pRing, uint32_t size);
+
+private:
+	void release(uint64_t begin, uint64_t end);
+
+	struct View;
+
+	char*						_data;
+	uint32_t						_capacity;
+	bool						_mirrored;
+	uint64_t						_head; // position written, accessed by the writer only
+	std::atomic<uint64_t>			_tail; // position released
+	std::map<uint64_t, uint64_t>	_released; // views released before an older one, protected by _mutex
+	std::mutex					_mutex;
+};
+
+
+} // namespace Mona
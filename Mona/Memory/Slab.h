@@ -0,0 +1,166 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#pragma once
+
+#include "Mona/Mona.h"
+#include <atomic>
+#include <cstddef>
+
+namespace Mona {
+
+/*!
+Recycles memory blocks of one size (short-lived objects like runners),
+each thread keeps its own lists of free blocks to allocate/free without lock,
+and exchanges them by batch with a shared lock-free list (a block is often allocated by one thread and released by an other).
+Memory is never given back to the system, it stays bounded by the peak of living blocks plus the free blocks kept by thread
+(2*FLUSH at most, a thread takes from the shared list FLUSH blocks at once, and gives the rest back) */
+template<std::size_t size>
+struct Slab : virtual Static {
+	static void* Alloc() {
+		Cache* pCache = GetCache();
+		void* block = pCache ? pCache->pop() : NULL;
+		return block ? block : ::operator new(SIZE);
+	}
+	static void Free(void* block) {
+		Cache* pCache = GetCache();
+		if (pCache)
+			return pCache->push((Block*)block);
+		// thread cache released (thread exiting)
+		Push((Block*)block, (Block*)block);
+	}
+
+private:
+	struct Block { Block* pNext; };
+	enum {
+		SIZE = size < sizeof(Block) ? sizeof(Block) : size,
+		FLUSH = 128 // free blocks kept by thread before to give them to other threads
+	};
+
+	static std::atomic<Block*>& Blocks() { static std::atomic<Block*> Blocks(nullptr); return Blocks; }
+	/*!
+	Push the chained blocks pFirst..pLast in the shared list */
+	static void Push(Block* pFirst, Block* pLast) {
+		Block* pHead = Blocks().load(std::memory_order_relaxed);
+		do {
+			pLast->pNext = pHead;
+		} while (!Blocks().compare_exchange_weak(pHead, pFirst, std::memory_order_release, std::memory_order_relaxed));
+	}
+
+	struct Cache : virtual Object {
+		Cache() : _pFree(NULL), _pLast(NULL), _count(0), _pReserve(NULL) {}
+		~Cache() {
+			if (_pFree)
+				Push(_pFree, _pLast);
+			if (!_pReserve)
+				return;
+			Block* pLast = _pReserve;
+			while (pLast->pNext)
+				pLast = pLast->pNext;
+			Push(_pReserve, pLast);
+		}
+		Block* pop() {
+			Block* pBlock;
+			if (_pFree) {
+				// LIFO to reuse a hot block
+				pBlock = _pFree;
+				if (!(_pFree = _pFree->pNext))
+					_pLast = NULL;
+				--_count;
+				return pBlock;
+			}
+			if (!_pReserve && !(_pReserve = Take()))
+				return NULL;
+			pBlock = _pReserve;
+			_pReserve = _pReserve->pNext;
+			return pBlock;
+		}
+		void push(Block* pBlock) {
+			if (!(pBlock->pNext = _pFree))
+				_pLast = pBlock;
+			_pFree = pBlock;
+			if (++_count < FLUSH)
+				return;
+			Push(_pFree, _pLast);
+			_pFree = _pLast = NULL;
+			_count = 0;
+		}
+	private:
+		/*!
+		Take FLUSH blocks from the shared list: all the list is taken at once (no ABA issue contrary to a pop by block)
+		then the rest is given back, without to browse it if nobody has pushed meanwhile */
+		static Block* Take() {
+			Block* pFirst = Blocks().exchange(nullptr, std::memory_order_acquire);
+			if (!pFirst)
+				return NULL;
+			Block* pLast = pFirst;
+			for (uint32_t count = 1; count < FLUSH && pLast->pNext; ++count)
+				pLast = pLast->pNext;
+			Block* pRest = pLast->pNext;
+			pLast->pNext = NULL;
+			if (!pRest)
+				return pFirst;
+			Block* pHead = nullptr;
+			if (Blocks().compare_exchange_strong(pHead, pRest, std::memory_order_release, std::memory_order_relaxed))
+				return pFirst;
+			for (pLast = pRest; pLast->pNext; pLast = pLast->pNext);
+			Push(pRest, pLast);
+			return pFirst;
+		}
+
+		Block*		_pFree; // blocks released by this thread
+		Block*		_pLast;
+		uint32_t	_count;
+		Block*		_pReserve; // blocks taken from the shared list
+	};
+
+	static Cache* GetCache() {
+		static thread_local bool Released(false);
+		static thread_local struct Holder : Cache { ~Holder() { Released = true; } } Cache;
+		return Released ? NULL : &Cache;
+	}
+};
+
+/*!
+Standard allocator on Slab to allocate objects by recycled blocks, typically to use with std::allocate_shared
+(sizes are rounded to 16 bytes to share blocks between close types) */
+template<typename Type>
+struct SlabAllocator {
+	typedef Type value_type;
+
+	SlabAllocator() {}
+	template<typename OtherType>
+	SlabAllocator(const SlabAllocator<OtherType>& other) {}
+
+	Type* allocate(std::size_t count) {
+		if (count == 1 && alignof(Type) <= alignof(std::max_align_t))
+			return (Type*)Slab<(sizeof(Type) + 15) & ~std::size_t(15)>::Alloc();
+		return std::allocator<Type>().allocate(count);
+	}
+	void deallocate(Type* data, std::size_t count) {
+		if (count == 1 && alignof(Type) <= alignof(std::max_align_t))
+			return Slab<(sizeof(Type) + 15) & ~std::size_t(15)>::Free(data);
+		std::allocator<Type>().deallocate(data, count);
+	}
+
+	template<typename OtherType>
+	bool operator==(const SlabAllocator<OtherType>& other) const { return true; }
+	template<typename OtherType>
+	bool operator!=(const SlabAllocator<OtherType>& other) const { return false; }
+};
+
+
+} // namespace Mona
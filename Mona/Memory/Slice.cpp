@@ -0,0 +1,105 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#include "Mona/Memory/Slice.h"
+
+using namespace std;
+
+
+namespace Mona {
+
+Slice& Slice::operator=(const Slice& slice) {
+	_pBuffer = slice._pBuffer;
+	_data = slice._data;
+	_size = slice._size;
+	return self;
+}
+
+Slice& Slice::operator=(Slice&& slice) {
+	_pBuffer = move(slice._pBuffer);
+	_data = slice._data;
+	_size = slice._size;
+	slice._data = NULL;
+	slice._size = 0;
+	return self;
+}
+
+Slice Slice::operator()(uint32_t offset, uint32_t size) const {
+	Slice slice(self);
+	slice += offset;
+	if (size < slice._size)
+		slice._size = size;
+	return slice;
+}
+
+Packet Slice::packet() const {
+	if (!_pBuffer)
+		return nullptr;
+	return Packet(static_pointer_cast<const Bytes>(_pBuffer), _data, _size);
+}
+
+Slice& Slice::append(const void* data, uint32_t size) {
+	if (!size)
+		return self;
+	if (_pBuffer && (_data + _size) == _pBuffer->end() && _pBuffer.unique()) {
+		// holds the end of the buffer and nobody else references it, forget consumed bytes to reuse their place rather reallocate
+		_pBuffer->clip(_data - _pBuffer->data());
+		_pBuffer->append(data, size);
+		_data = _pBuffer->data();
+		_size = _pBuffer->size();
+		return self;
+	}
+	// copy-on-write, a buffer shared with packets (maybe of other threads) is immutable, its size included
+	Shared<Buffer> pBuffer(SET, _size + size);
+	if (_size)
+		memcpy(pBuffer->data(), _data, _size);
+	memcpy(pBuffer->data() + _size, data, size);
+	_pBuffer = move(pBuffer);
+	_data = _pBuffer->data();
+	_size = _pBuffer->size();
+	return self;
+}
+
+Slice& Slice::operator+=(uint32_t offset) {
+	if (offset > _size)
+		offset = _size;
+	_data += offset;
+	_size -= offset;
+	return self;
+}
+
+Slice& Slice::reset() {
+	_pBuffer.reset();
+	_data = NULL;
+	_size = 0;
+	return self;
+}
+
+Shared<Buffer>& Slice::release(Shared<Buffer>& pBuffer) {
+	if (!_size)
+		pBuffer.reset();
+	else if (_pBuffer.unique()) {
+		_pBuffer->clip(_data - _pBuffer->data());
+		_pBuffer->resize(_size);
+		pBuffer = move(_pBuffer);
+	} else
+		pBuffer.set(_data, _size);
+	reset();
+	return pBuffer;
+}
+
+
+} // namespace Mona
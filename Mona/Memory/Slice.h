@@ -0,0 +1,74 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#pragma once
+
+#include "Mona/Mona.h"
+#include "Mona/Memory/Packet.h"
+
+namespace Mona {
+
+/*!
+Slice is a growable view on a shared Buffer, to accumulate data without repeated allocation or memmove:
+- sub-slices and packets share the buffer without copy, and consuming bytes at the beginning just moves the view
+- append writes in place when the slice holds the end of its buffer and nobody else references the buffer,
+otherwise the slice copies its bytes in a new buffer (copy-on-write).
+So a buffer referenced by an other slice or packet never changes, neither its bytes nor its size. Not thread-safe, like Buffer */
+struct Slice : Bytes, virtual Object {
+	NULLABLE(!_size)
+
+	Slice() : _data(NULL), _size(0) {}
+	/*!
+	Capture the buffer passed in parameter */
+	Slice(Shared<Buffer>&& pBuffer) : _pBuffer(std::move(pBuffer)), _data(_pBuffer ? _pBuffer->data() : NULL), _size(_pBuffer ? _pBuffer->size() : 0) {}
+	/*!
+	Share the buffer of slice */
+	Slice(const Slice& slice) : _pBuffer(slice._pBuffer), _data(slice._data), _size(slice._size) {}
+	Slice(Slice&& slice) : _pBuffer(std::move(slice._pBuffer)), _data(slice._data), _size(slice._size) { slice._data = NULL; slice._size = 0; }
+
+	Slice& operator=(const Slice& slice);
+	Slice& operator=(Slice&& slice);
+
+	const char*	data() const override { return _data; }
+	uint32_t		size() const override { return _size; }
+
+	/*!
+	Sub-slice of size bytes from offset sharing the same buffer */
+	Slice		operator()(uint32_t offset, uint32_t size = 0xFFFFFFFF) const;
+	/*!
+	Packet referencing the slice, sharing the same buffer */
+	Packet		packet() const;
+
+	/*!
+	Append data, copy the slice in a new buffer if the buffer is shared or doesn't end with the slice (copy-on-write) */
+	Slice&		append(const void* data, uint32_t size);
+	/*!
+	Move the beginning of the slice of offset bytes (consumed bytes) */
+	Slice&		operator+=(uint32_t offset);
+	Slice&		clip(uint32_t offset) { return operator+=(offset); }
+	Slice&		reset();
+	/*!
+	Move the slice in pBuffer, without copy if the slice is the only one to reference its buffer, returns pBuffer */
+	Shared<Buffer>& release(Shared<Buffer>& pBuffer);
+
+private:
+	Shared<Buffer>	_pBuffer;
+	char*			_data;
+	uint32_t			_size;
+};
+
+
+} // namespace Mona
@@ -30,6 +30,11 @@ details (or else see http://mozilla.org/MPL/2.0/).
 #define EPOLLRDHUP 0x2000 // looks be just a SDL include forget for Android, but the event is implemented in epoll of Android
 #endif  // !defined(EPOLLRDHUP) 
 #endif
+#include "Mona/Net/IOUring.h"
+#if defined(MONA_IO_URING)
+	#include <poll.h>
+	#include <unordered_map>
+#endif
 #include "Mona/Net/SRT.h"
 #if defined(SRT_API)
 	#include "Mona/Net/IOSRTSocket.h"
@@ -73,6 +78,14 @@ protected:
 			pSocket->_pHandler->queue<HandleType>(name, pSocket, _ex, std::forward<Args>(args)...);
 		_ex = NULL;
 	}
+	/*!
+	Build a handle in handles rather queueing it, to queue handles at once to handler */
+	template<typename HandleType, typename ...Args>
+	void handle(std::vector<Shared<Runner>>& handles, const Shared<Socket>& pSocket, Args&&... args) {
+		if (!pSocket.unique())
+			handles.emplace_back(Runner::Make<HandleType>(name, pSocket, _ex, std::forward<Args>(args)...));
+		_ex = NULL;
+	}
 
 private:
 	bool run(Exception&) {
@@ -92,12 +105,615 @@ private:
 	Exception		_ex;
 };
 
+/*!
+Link to an IOSocket for runners and handles which resume a reception after its consumption, invalidated on IOSocket deletion */
+struct IOSocket::Link : virtual Object {
+	Link(IOSocket& io) : _pIO(&io) {}
+
+	void resume(Socket& socket) {
+		lock_guard<mutex> lock(_mutex);
+		if (_pIO)
+			_pIO->resume(socket);
+	}
+	void reset() {
+		lock_guard<mutex> lock(_mutex);
+		_pIO = NULL;
+	}
+private:
+	mutex		_mutex;
+	IOSocket*	_pIO;
+};
+
+#if defined(MONA_IO_URING)
+
+/*!
+Receptions of the io_uring backend, gotten by the ring in buffers of Buffer::Allocator, decoded and handled as a batch */
+struct IOSocket::Received : Action {
+	Received(const Shared<Link>& pLink, const Shared<Socket>& pSocket) : Action("SocketReceive", 0, pSocket), pLink(pLink), resume(false) {}
+
+	const Shared<Link>	pLink;
+	bool				resume; // reception paused by the ring, to resume once the last reception consumed
+
+	void add(Shared<Buffer>& pBuffer, const SocketAddress& address) { _receptions.emplace_back(move(pBuffer), address); }
+
+private:
+	struct Reception {
+		Reception(Shared<Buffer>&& pBuffer, const SocketAddress& address) : pBuffer(move(pBuffer)), address(address) {}
+		Shared<Buffer>	pBuffer;
+		SocketAddress	address;
+	};
+	struct Handle : Action::Handle {
+		Handle(const char* name, const Shared<Socket>& pSocket, const Exception& ex, Shared<Buffer>& pBuffer, const SocketAddress& address, uint32_t size, const Shared<Link>& pResume) :
+			Action::Handle(name, pSocket, ex), _address(address), _pBuffer(move(pBuffer)), _size(size), _pResume(pResume) {}
+	private:
+		void handle(const Shared<Socket>& pSocket) {
+			pSocket->_onReceived(_pBuffer, _address);
+			pSocket->_receiving -= _size;
+			if (_pResume)
+				_pResume->resume(*pSocket);
+		}
+		Shared<Buffer>		_pBuffer;
+		SocketAddress		_address;
+		uint32_t			_size;
+		Shared<Link>		_pResume;
+	};
+
+	bool process(Exception& ex, const Shared<Socket>& pSocket) {
+		vector<Shared<Runner>> handles; // queued at once to handler
+		for (size_t i = 0; i < _receptions.size(); ++i) {
+			Reception& reception(_receptions[i]);
+			Shared<Link> pResume;
+			if (resume && (i + 1) == _receptions.size())
+				pResume = pLink;
+			uint32_t size(reception.pBuffer->size());
+			if (pSocket->_pDecoder)
+				pSocket->_pDecoder->decode(reception.pBuffer, reception.address, pSocket);
+			if (reception.pBuffer) {
+				handle<Handle>(handles, pSocket, reception.pBuffer, reception.address, size, pResume);
+				continue;
+			}
+			pSocket->_receiving -= size;
+			if (pResume)
+				pResume->resume(*pSocket);
+		}
+		if (!handles.empty())
+			pSocket->_pHandler->queue(handles);
+		return true;
+	}
+
+	vector<Reception>	_receptions;
+};
+
+/*!
+Connections accepted by the ring (multishot accept), built and handled as a batch */
+struct IOSocket::Accepted : Action {
+	Accepted(const Shared<Link>& pLink, const Shared<Socket>& pSocket) : Action("SocketAccept", 0, pSocket), pLink(pLink), resume(false) { lane = LANE_HIGH; }
+	~Accepted() {
+		for (NET_SOCKET sockfd : _sockets) {
+			if (sockfd != NET_INVALID_SOCKET)
+				NET_CLOSESOCKET(sockfd); // not processed
+		}
+	}
+
+	const Shared<Link>	pLink;
+	bool				resume; // accept paused by the ring, to resume once the last connection handled
+
+	void add(NET_SOCKET sockfd) { _sockets.emplace_back(sockfd); }
+
+private:
+	struct Handle : Action::Handle {
+		Handle(const char* name, const Shared<Socket>& pSocket, const Exception& ex, Shared<Socket>& pConnection, const Shared<Link>& pResume) :
+			Action::Handle(name, pSocket, ex), _pConnection(move(pConnection)), _pResume(pResume) {}
+	private:
+		void handle(const Shared<Socket>& pSocket) {
+			pSocket->_onAccept(_pConnection);
+			--pSocket->_receiving;
+			if (_pResume)
+				_pResume->resume(*pSocket);
+		}
+		Shared<Socket>		_pConnection;
+		Shared<Link>		_pResume;
+	};
+
+	bool process(Exception& ex, const Shared<Socket>& pSocket) {
+		vector<Shared<Runner>> handles; // queued at once to handler
+		for (size_t i = 0; i < _sockets.size(); ++i) {
+			NET_SOCKET& sockfd(_sockets[i]);
+			Shared<Link> pResume;
+			if (resume && (i + 1) == _sockets.size())
+				pResume = pLink;
+			union {
+				struct sockaddr_in  sa_in;
+				struct sockaddr_in6 sa_in6;
+			} addr;
+			NET_SOCKLEN addrSize = sizeof(addr);
+			Shared<Socket> pConnection;
+			if (::getpeername(sockfd, (sockaddr*)&addr, &addrSize) == 0)
+				pConnection = pSocket->newSocket(ex, sockfd, (sockaddr&)addr);
+			else
+				Socket::SetException(ex);
+			if (pConnection) {
+				sockfd = NET_INVALID_SOCKET; // owned by pConnection
+				handle<Handle>(handles, pSocket, pConnection, pResume);
+				continue;
+			}
+			NET_CLOSESOCKET(sockfd);
+			sockfd = NET_INVALID_SOCKET;
+			--pSocket->_receiving;
+			if (pResume)
+				pResume->resume(*pSocket);
+		}
+		if (!handles.empty())
+			pSocket->_pHandler->queue(handles);
+		return true;
+	}
+
+	vector<NET_SOCKET>	_sockets;
+};
+
+/*!
+io_uring event loop, used by IOSocket::run with BACKEND_IO_URING.
+Plain TCP and UDP sockets get a multishot reception (recv, recvmsg or accept) in provided buffers and a multishot poll for writing and errors,
+other sockets (TLS, reception ring) get just a multishot poll dispatched as epoll events (see IOSocket::dispatch).
+Subscriptions come by the pipe of IOSocket with the Weak<Socket>* pointer (tagged by its low bits) to keep one single issuer thread */
+struct IOSocket::Ring : IOUring, virtual Object {
+	enum {
+		CMD_REMOVE = 0, // untagged pointer, as written by unsubscribe
+		CMD_ADD,
+		CMD_RESUME,
+		CMD_MASK = 7
+	};
+
+	Ring(IOSocket& io, int readFD) : _io(io), _readFD(readFD), _batch(io.threadPool), _datagrams(false) {
+		memset(&_msg, 0, sizeof(_msg));
+		_msg.msg_namelen = sizeof(sockaddr_in6);
+	}
+
+	bool open(Exception& ex) {
+		if (!IOUring::open(ex, 1024, 16384))
+			return false;
+		if (provide(ex, GROUP_STREAM, 256, 0x4000)) // datagram buffers on first datagram socket, see command
+			return true;
+		close();
+		return false;
+	}
+
+	bool run(Exception& ex) {
+		arm(OP_COMMAND);
+		bool terminated(false);
+		int result;
+		for (;;) {
+			if ((result = submit(1)) < 0 && result != -EINTR && result != -EBUSY) // EBUSY => completions to consume before
+				break;
+			result = 0;
+			while (io_uring_cqe* pCQE = completion()) {
+				io_uring_cqe cqe(*pCQE);
+				next();
+				if ((cqe.user_data & OP_MASK) != OP_COMMAND)
+					complete(cqe);
+				else if (!command(cqe))
+					terminated = true; // termination signal on IOSocket deletion
+			}
+			flush();
+			if (terminated)
+				break;
+			if (!_io._subscribers) {
+				lock_guard<mutex> lock(_io._mutex);
+				// no more socket to manage?
+				if (!_io._subscribers) {
+					release();
+					_io.stop(); // to set running=false!
+					return true;
+				}
+			}
+		}
+		release();
+		if (result < 0) { // error
+			ex.set<Ex::Net::System>("impossible to manage sockets (error ", -result, ")");
+			return false;
+		}
+		if (!_io._subscribers)
+			return true; // IOSocket deletion
+		ex.set<Ex::Net::System>("dies with remaining sockets managed");
+		return false;
+	}
+
+private:
+	enum {
+		OP_COMMAND = 1,
+		OP_POLL,
+		OP_RECV, // recv, recvmsg or accept
+		OP_CANCEL,
+		OP_MASK = 7
+	};
+	enum {
+		GROUP_STREAM = 0,
+		GROUP_DATAGRAM
+	};
+	enum Kind {
+		KIND_POLL = 0,
+		KIND_STREAM,
+		KIND_DATAGRAM,
+		KIND_LISTENER
+	};
+	struct Subscription {
+		Subscription(Kind kind) : kind(kind), ops(0), poll(false), recv(false), paused(false), removed(false) {}
+		const Kind			kind;
+		uint8_t				ops; // operations armed
+		bool				poll;
+		bool				recv;
+		bool				paused; // backpressure
+		bool				removed;
+		// runner of the current completion batch
+		Shared<Socket>		pSocket;
+		Shared<Received>	pReceived;
+		Shared<Accepted>	pAccepted;
+	};
+	typedef unordered_map<Weak<Socket>*, Subscription>::iterator Iterator;
+
+	void arm(uint8_t op, Weak<Socket>* pWeak = NULL, Subscription* pSubscription = NULL, NET_SOCKET sockfd = NET_INVALID_SOCKET) {
+		if (op == OP_COMMAND) {
+			if (io_uring_sqe* pSQE = prepare(IORING_OP_POLL_ADD, _readFD, OP_COMMAND)) {
+				pSQE->poll32_events = POLLIN;
+				pSQE->len = IORING_POLL_ADD_MULTI;
+			}
+			return;
+		}
+		Subscription& subscription(*pSubscription);
+		io_uring_sqe* pSQE;
+		if (op == OP_POLL) {
+			if (!(pSQE = prepare(IORING_OP_POLL_ADD, sockfd, uint64_t(pWeak) | OP_POLL)))
+				return;
+			switch (subscription.kind) {
+				case KIND_POLL:
+					pSQE->poll32_events = POLLIN | POLLOUT | POLLRDHUP;
+					break;
+				case KIND_LISTENER:
+					pSQE->poll32_events = POLLIN; // connection waiting while accept is not armed
+					break;
+				default:
+					pSQE->poll32_events = POLLOUT; // errors and hang up are always polled
+			}
+			pSQE->len = IORING_POLL_ADD_MULTI;
+			subscription.poll = true;
+		} else {
+			switch (subscription.kind) {
+				case KIND_LISTENER:
+					if (!(pSQE = prepare(IORING_OP_ACCEPT, sockfd, uint64_t(pWeak) | OP_RECV)))
+						return;
+					pSQE->ioprio = IORING_ACCEPT_MULTISHOT;
+					break;
+				case KIND_DATAGRAM:
+					if (!(pSQE = prepare(IORING_OP_RECVMSG, sockfd, uint64_t(pWeak) | OP_RECV)))
+						return;
+					pSQE->addr = uint64_t(&_msg);
+					pSQE->len = 1;
+					pSQE->ioprio = IORING_RECV_MULTISHOT;
+					pSQE->flags = IOSQE_BUFFER_SELECT;
+					pSQE->buf_group = GROUP_DATAGRAM;
+					break;
+				default:
+					if (!(pSQE = prepare(IORING_OP_RECV, sockfd, uint64_t(pWeak) | OP_RECV)))
+						return;
+					pSQE->ioprio = IORING_RECV_MULTISHOT;
+					pSQE->flags = IOSQE_BUFFER_SELECT;
+					pSQE->buf_group = GROUP_STREAM;
+			}
+			subscription.recv = true;
+		}
+		++subscription.ops;
+	}
+
+	void cancel(Weak<Socket>* pWeak, uint8_t op) {
+		if (io_uring_sqe* pSQE = prepare(IORING_OP_ASYNC_CANCEL, -1, uint64_t(pWeak) | OP_CANCEL))
+			pSQE->addr = uint64_t(pWeak) | op;
+	}
+
+	void remove(Iterator& it) {
+		Subscription& subscription(it->second);
+		subscription.removed = true;
+		if (subscription.poll)
+			cancel(it->first, OP_POLL);
+		if (subscription.recv)
+			cancel(it->first, OP_RECV);
+		if (subscription.ops)
+			return; // wait final completions
+		delete it->first;
+		_subscriptions.erase(it);
+	}
+
+	bool command(const io_uring_cqe& cqe) {
+		uintptr_t command;
+		while (::read(_readFD, &command, sizeof(command)) == sizeof(command)) {
+			Weak<Socket>* pWeak((Weak<Socket>*)(command & ~uintptr_t(CMD_MASK)));
+			Iterator it(_subscriptions.find(pWeak));
+			switch (command & CMD_MASK) {
+				case CMD_ADD: {
+					Shared<Socket> pSocket(pWeak->lock());
+					if (!pSocket) {
+						delete pWeak; // socket dies without unsubscription
+						break;
+					}
+					Kind kind(KIND_POLL);
+					if (!pSocket->isSecure() && !pSocket->_pRecvRing)
+						kind = pSocket->listening() ? KIND_LISTENER : (pSocket->type == Socket::TYPE_STREAM ? KIND_STREAM : KIND_DATAGRAM);
+					if (kind == KIND_DATAGRAM && !_datagrams) {
+						// datagram buffers get the recvmsg header and the address before the payload
+						Exception ex;
+						if (provide(ex, GROUP_DATAGRAM, 256, max(_io._datagramSize, uint32_t(sizeof(io_uring_recvmsg_out) + sizeof(sockaddr_in6) + 1))))
+							_datagrams = true;
+						else {
+							WARN("io_uring datagram sockets polled, ", ex);
+							kind = KIND_POLL;
+						}
+					}
+					Subscription& subscription(_subscriptions.emplace(pWeak, kind).first->second);
+					arm(OP_POLL, pWeak, &subscription, *pSocket);
+					// stream connected or not, the first POLLOUT arms the reception (recv on a not connected socket fails)
+					if (kind == KIND_DATAGRAM)
+						arm(OP_RECV, pWeak, &subscription, *pSocket);
+					break;
+				}
+				case CMD_RESUME:
+					if (it == _subscriptions.end() || it->second.removed || !it->second.paused)
+						break;
+					it->second.paused = false;
+					if (!it->second.recv) { // else cancellation in progress, rearmed on its completion
+						Shared<Socket> pSocket(pWeak->lock());
+						if (pSocket)
+							arm(OP_RECV, pWeak, &it->second, *pSocket);
+					}
+					break;
+				default: // CMD_REMOVE
+					if (it != _subscriptions.end() && !it->second.removed)
+						remove(it);
+			}
+		}
+		if (cqe.res < 0 || (cqe.res & POLLHUP))
+			return false; // pipe closed on IOSocket deletion
+		if (!(cqe.flags & IORING_CQE_F_MORE))
+			arm(OP_COMMAND);
+		return true;
+	}
+
+	void complete(const io_uring_cqe& cqe) {
+		uint8_t op(cqe.user_data & OP_MASK);
+		if (op == OP_CANCEL)
+			return;
+		Weak<Socket>* pWeak((Weak<Socket>*)(cqe.user_data & ~uint64_t(OP_MASK)));
+		Iterator it(_subscriptions.find(pWeak));
+		if (it == _subscriptions.end())
+			return;
+		Subscription& subscription(it->second);
+		Shared<Buffer> pBuffer;
+		if (cqe.flags & IORING_CQE_F_BUFFER) // buffer to take back in any case
+			pBuffer = take(subscription.kind == KIND_DATAGRAM ? GROUP_DATAGRAM : GROUP_STREAM, cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+		bool more(cqe.flags & IORING_CQE_F_MORE ? true : false);
+		if (!more) {
+			--subscription.ops;
+			(op == OP_POLL ? subscription.poll : subscription.recv) = false;
+		}
+		Shared<Socket> pSocket;
+		if (subscription.removed || !(pSocket = pWeak->lock())) {
+			if (op == OP_RECV && subscription.kind == KIND_LISTENER && cqe.res >= 0)
+				NET_CLOSESOCKET(cqe.res); // connection accepted meanwhile
+			if (!subscription.removed)
+				remove(it); // socket dies without unsubscription, release its operations (they hold its file)
+			else if (!subscription.ops) {
+				delete pWeak;
+				_subscriptions.erase(it);
+			}
+			return;
+		}
+		if (op == OP_POLL)
+			poll(pWeak, subscription, pSocket, cqe.res, more);
+		else if (subscription.kind == KIND_LISTENER)
+			accept(pWeak, subscription, pSocket, cqe.res, more);
+		else
+			receive(pWeak, subscription, pSocket, cqe.res, pBuffer, more);
+	}
+
+	void poll(Weak<Socket>* pWeak, Subscription& subscription, const Shared<Socket>& pSocket, int result, bool more) {
+		if (result >= 0) {
+			flush(subscription); // receptions before any event
+			if (subscription.kind == KIND_POLL)
+				_io.dispatch(pSocket, uint32_t(result)); // same events values as epoll
+			else {
+				int error(0);
+				if (result & POLLERR) {
+					socklen_t len(sizeof(error));
+					if (getsockopt(pSocket->id(), SOL_SOCKET, SO_ERROR, (void *)&error, &len) == -1)
+						error = Net::LastError();
+				}
+				if (result & POLLHUP) {
+					// not connected stream socket is in HUP, a failed connection has an error (reception gets the normal disconnection)
+					if (error && subscription.kind == KIND_STREAM) {
+						_io.close(pSocket, error);
+						error = 0;
+					}
+				} else if (result & (POLLOUT | POLLIN)) {
+					// EPOLLOUT in first to get the onFlush (onConnection for TCP) in first (before any reception)
+					if (result & POLLOUT) {
+						_io.write(pSocket, error);
+						error = 0;
+					}
+					if (!subscription.recv && !subscription.paused)
+						arm(OP_RECV, pWeak, &subscription, *pSocket); // connected or connection waiting
+				}
+				if (error) // on few unix system we can get an error without anything else
+					_io.threadPool.queue<Action>(pSocket->_threadReceive, "SocketError", error, pSocket);
+			}
+		}
+		if (!more && !subscription.removed && result != -ECANCELED)
+			arm(OP_POLL, pWeak, &subscription, *pSocket);
+	}
+
+	void accept(Weak<Socket>* pWeak, Subscription& subscription, const Shared<Socket>& pSocket, int result, bool more) {
+		if (result < 0) {
+			if (result != -ECANCELED) {
+				flush(subscription);
+				_io.threadPool.queue<Action>(pSocket->_threadReceive, "SocketError", -result, pSocket);
+			} // else rearmed by POLLIN or resume
+			return;
+		}
+		if (!subscription.pAccepted) {
+			if (!pSocket->_receiving)
+				_io.threadPool.rebalance(pSocket->_threadReceive); // no connection pending, track can move if its thread is drained
+			subscription.pSocket = pSocket;
+			subscription.pAccepted = Runner::Make<Accepted>(_io._pLink, pSocket);
+			_pendings.emplace_back(pWeak);
+		}
+		subscription.pAccepted->add(result);
+		if (++pSocket->_receiving < Socket::BACKLOG_MAX && !pSocket->_pHandler->saturated())
+			return;
+		pause(pWeak, subscription, more);
+	}
+
+	void receive(Weak<Socket>* pWeak, Subscription& subscription, const Shared<Socket>& pSocket, int result, Shared<Buffer>& pBuffer, bool more) {
+		if (result <= 0 || !pBuffer) {
+			if (more)
+				return;
+			if (result == -ENOBUFS || (result == -ECANCELED && !subscription.paused)) {
+				if (!subscription.removed)
+					arm(OP_RECV, pWeak, &subscription, *pSocket); // buffers given back, or resumed meanwhile
+				return;
+			}
+			if (result == -ECANCELED)
+				return; // paused
+			flush(subscription);
+			if (subscription.kind == KIND_DATAGRAM) {
+				if (result) // error, but not necessary a disconnection
+					_io.threadPool.queue<Action>(pSocket->_threadReceive, "SocketError", -result, pSocket);
+				if (!subscription.removed)
+					arm(OP_RECV, pWeak, &subscription, *pSocket);
+			} else if (!result) // a recv returns 0 without any error when TCP socket is disconnected
+				_io.close(pSocket, 0);
+			else if (result != -ENOTCONN) // not connected => rearmed by next POLLOUT
+				_io.close(pSocket, -result);
+			return;
+		}
+
+		SocketAddress address;
+		if (subscription.kind == KIND_DATAGRAM) {
+			const io_uring_recvmsg_out& out(*(io_uring_recvmsg_out*)pBuffer->data());
+			uint32_t offset(sizeof(io_uring_recvmsg_out) + _msg.msg_namelen + _msg.msg_controllen);
+			if (uint32_t(result) < offset)
+				return;
+			if (out.flags & MSG_TRUNC) { // packet lost!
+				flush(subscription);
+				_io.threadPool.queue<Action>(pSocket->_threadReceive, "SocketError", NET_EMSGSIZE, pSocket);
+				return;
+			}
+			address.set(*(sockaddr*)(pBuffer->data() + sizeof(io_uring_recvmsg_out)));
+			result = min(out.payloadlen, uint32_t(result) - offset);
+			if (uint32_t(result) < (pBuffer->capacity() / 4)) {
+				// copy a small datagram to not hold the whole buffer (_receiving counts just the payload)
+				Shared<Buffer> pCopy(SET, pBuffer->data() + offset, result);
+				pBuffer = move(pCopy);
+			} else
+				pBuffer->clip(offset);
+		} else
+			address.set(pSocket->peerAddress());
+		pBuffer->resize(result);
+		pSocket->receive(uint32_t(result));
+
+		if (!subscription.pReceived) {
+			if (!pSocket->_receiving)
+				_io.threadPool.rebalance(pSocket->_threadReceive); // no reception pending, track can move if its thread is drained
+			subscription.pSocket = pSocket;
+			subscription.pReceived = Runner::Make<Received>(_io._pLink, pSocket);
+			_pendings.emplace_back(pWeak);
+		}
+		subscription.pReceived->add(pBuffer, address);
+		// stop reception if socket or handler backlog is too deep, resumed when the batch is consumed
+		if ((pSocket->_receiving += result) < pSocket->recvBufferSize() && !pSocket->_pHandler->saturated())
+			return;
+		pause(pWeak, subscription, more);
+	}
+
+	void pause(Weak<Socket>* pWeak, Subscription& subscription, bool more) {
+		if (subscription.paused)
+			return;
+		subscription.paused = true;
+		if (subscription.pReceived)
+			subscription.pReceived->resume = true;
+		else
+			subscription.pAccepted->resume = true;
+		if (more)
+			cancel(pWeak, OP_RECV);
+	}
+
+	/*!
+	Queue the runner of the current batch of subscription, to keep order with an other event */
+	void flush(Subscription& subscription) {
+		if (subscription.pReceived)
+			_io.threadPool.queue(subscription.pSocket->_threadReceive, move(subscription.pReceived));
+		if (subscription.pAccepted)
+			_io.threadPool.queue(subscription.pSocket->_threadReceive, move(subscription.pAccepted));
+		subscription.pSocket.reset();
+	}
+	/*!
+	Queue runners of the completion batch at once by thread */
+	void flush() {
+		for (Weak<Socket>* pWeak : _pendings) {
+			Iterator it(_subscriptions.find(pWeak));
+			if (it == _subscriptions.end())
+				continue;
+			Subscription& subscription(it->second);
+			if (subscription.pReceived)
+				_batch.add(subscription.pSocket->_threadReceive, move(subscription.pReceived));
+			if (subscription.pAccepted)
+				_batch.add(subscription.pSocket->_threadReceive, move(subscription.pAccepted));
+			subscription.pSocket.reset();
+		}
+		_pendings.clear();
+		_batch.flush();
+	}
+
+	void release() {
+		io_uring_cqe cqe;
+		memset(&cqe, 0, sizeof(cqe));
+		command(cqe); // last removals
+		for (auto& it : _subscriptions) {
+			if (it.second.removed)
+				delete it.first; // else always owned by its socket
+		}
+		_subscriptions.clear();
+		::close(_readFD);  // close reader pipe side
+		close(); // close the ring, cancels operations
+	}
+
+	IOSocket&										_io;
+	int												_readFD;
+	msghdr											_msg; // recvmsg format (name without control)
+	bool											_datagrams; // datagram buffers provided
+	unordered_map<Weak<Socket>*, Subscription>		_subscriptions;
+	vector<Weak<Socket>*>							_pendings;
+	ThreadPool::Batch								_batch;
+};
+
+void IOSocket::resume(Socket& socket) {
+	lock_guard<mutex> lock(_mutex); // _pWeakThis is reset on unsubscription with lock
+	if (!running() || !_system || !socket._pWeakThis)
+		return;
+	uintptr_t command(uintptr_t(socket._pWeakThis) | Ring::CMD_RESUME);
+	if (::write(_eventFD, &command, sizeof(command)) < 0) // ignore error (IOSocket dies)
+		return;
+}
 
-IOSocket::IOSocket(const Handler& handler, const ThreadPool& threadPool) : _initSignal(false),
-   _system(0), _subscribers(0),handler(handler), threadPool(threadPool) {
+#else
+
+void IOSocket::resume(Socket& socket) {}
+
+#endif
+
+
+IOSocket::IOSocket(const Handler& handler, const ThreadPool& threadPool) : _initSignal(false), _pLink(SET, self),
+   _system(0), _subscribers(0), _backend(BACKEND_POLL), _datagramSize(0x10000), _listeners(0), handler(handler), threadPool(threadPool) {
 }
 
 IOSocket::~IOSocket() {
+	_pLink->reset(); // pending resumes are ignored now
 	if (!running())
 		return;
 	_initSignal.wait(); // wait _eventSystem assignment
@@ -111,6 +727,57 @@ IOSocket::~IOSocket() {
 	Thread::stop();
 }
 
+uint32_t IOSocket::subscribers() const {
+	uint32_t subscribers(_subscribers);
+	for (const Unique<IOSocket>& pReactor : _reactors)
+		subscribers += pReactor->_subscribers;
+	return subscribers;
+}
+
+IOSocket& IOSocket::setBackend(Backend backend) {
+	_backend = backend;
+	for (Unique<IOSocket>& pReactor : _reactors)
+		pReactor->setBackend(backend);
+	return self;
+}
+
+IOSocket& IOSocket::setDatagramSize(uint32_t size) {
+	_datagramSize = size;
+	for (Unique<IOSocket>& pReactor : _reactors)
+		pReactor->setDatagramSize(size);
+	return self;
+}
+
+IOSocket& IOSocket::setReactors(uint16_t count) {
+	lock_guard<mutex> lock(_mutex);
+	if (subscribers())
+		return self; // sockets already sharded
+	_reactors.resize(count ? (count - 1) : 0);
+	for (Unique<IOSocket>& pReactor : _reactors) {
+		if (pReactor)
+			continue;
+		pReactor.set(handler, threadPool).setBackend(_backend).setDatagramSize(_datagramSize);
+		pReactor->setAffinity(affinity());
+		pReactor->setRealTime(realTime());
+	}
+	return self;
+}
+
+uint16_t IOSocket::shard(const Socket& socket) const {
+	// listening socket on the reactor with the fewer listening sockets (SO_REUSEPORT, see TCPServer), others on the reactor with the fewer sockets
+	bool listening(socket.listening());
+	uint32_t fewer(listening ? _listeners : _subscribers);
+	uint16_t reactor(0);
+	for (uint16_t i = 0; i < _reactors.size(); ++i) {
+		uint32_t count(listening ? _reactors[i]->_listeners : _reactors[i]->_subscribers);
+		if (count < fewer) {
+			fewer = count;
+			reactor = i + 1;
+		}
+	}
+	return reactor;
+}
+
 bool IOSocket::subscribe(Exception& ex, const Shared<Socket>& pSocket,
 											const Socket::OnReceived& onReceived,
 											const Socket::OnFlush& onFlush,
@@ -156,6 +823,15 @@ bool IOSocket::subscribe(Exception& ex, const Shared<Socket>& pSocket,
 }
 
 bool IOSocket::subscribe(Exception& ex, const Shared<Socket>& pSocket) {
+	if (!_reactors.empty()) {
+		uint16_t reactor(shard(*pSocket));
+		if (reactor) {
+			if (!_reactors[reactor - 1]->subscribe(ex, pSocket))
+				return false;
+			pSocket->_reactor = reactor;
+			return true;
+		}
+	}
 	lock_guard<mutex> lock(_mutex); // must protect "start" + _system (to avoid a write operation on restarting) + _subscribers increment
 	if (!running()) {
 		_initSignal.reset();
@@ -185,12 +861,22 @@ bool IOSocket::subscribe(Exception& ex, const Shared<Socket>& pSocket) {
 	EV_SET(&events[1], *pSocket, EVFILT_WRITE, EV_ADD | EV_CLEAR, 0, 0, pSocket->_pWeakThis);
 	res = kevent(_system, events, 2, NULL, 0, NULL);
 #else
+#if defined(MONA_IO_URING)
+	if (_backend == BACKEND_IO_URING) {
+		// the ring thread is the only one to touch the ring (single issuer)
+		uintptr_t command(uintptr_t(pSocket->_pWeakThis) | Ring::CMD_ADD);
+		res = ::write(_eventFD, &command, sizeof(command)) < 0 ? -1 : 0;
+	} else {
+#endif
 	epoll_event event;
 	memset(&event, 0, sizeof(event));
 	event.events = EPOLLIN | EPOLLRDHUP | EPOLLOUT | EPOLLET;
 	event.data.fd = *pSocket;
 	event.data.ptr = pSocket->_pWeakThis;
 	res = epoll_ctl(_system, EPOLL_CTL_ADD, *pSocket, &event);
+#if defined(MONA_IO_URING)
+	}
+#endif
 #endif
 	if (res<0) {
 		delete pSocket->_pWeakThis;
@@ -200,7 +886,8 @@ bool IOSocket::subscribe(Exception& ex, const Shared<Socket>& pSocket) {
 	}
 #endif
 	++_subscribers;
-	
+	if (pSocket->listening())
+		++_listeners;
 	return true;
 }
 
@@ -222,6 +909,11 @@ void IOSocket::unsubscribe(Shared<Socket>& pSocket) {
 }
 
 void IOSocket::unsubscribe(Socket* pSocket) {
+	if (pSocket->_reactor) {
+		IOSocket& reactor(*_reactors[pSocket->_reactor - 1]);
+		pSocket->_reactor = 0;
+		return reactor.unsubscribe(pSocket);
+	}
 #if defined(_WIN32)
 	{
 		// decrements _count before the PostMessage
@@ -236,6 +928,8 @@ void IOSocket::unsubscribe(Socket* pSocket) {
 
 	lock_guard<mutex> lock(_mutex); // to avoid a restart during _system reading + protected _count decrement
 	--_subscribers;
+	if (pSocket->listening())
+		--_listeners;
 
 	// if running _initSignal is set, so _system is assigned
 #if defined(_WIN32)
@@ -252,9 +946,11 @@ void IOSocket::unsubscribe(Socket* pSocket) {
 		EV_SET(&events[1], *pSocket, EVFILT_WRITE, EV_DELETE, 0, 0, NULL);
 		kevent(_system, events, 2, NULL, 0, NULL);
 #else
-		epoll_event event;
-		memset(&event, 0, sizeof(event));
-		epoll_ctl(_system, EPOLL_CTL_DEL, *pSocket, &event);
+		if (_backend == BACKEND_POLL) { // else the ring cancels its operations on removal
+			epoll_event event;
+			memset(&event, 0, sizeof(event));
+			epoll_ctl(_system, EPOLL_CTL_DEL, *pSocket, &event);
+		}
 #endif
 		if (::write(_eventFD, &pSocket->_pWeakThis, sizeof(pSocket->_pWeakThis)) >= 0)
 			pSocket->_pWeakThis = NULL; // success!
@@ -276,12 +972,12 @@ void IOSocket::read(const Shared<Socket>& pSocket, int error) {
 	if (pSocket->listening()) {
 
 		struct Accept : Action {
-			Accept(int error, const Shared<Socket>& pSocket) : Action("SocketAccept", error, pSocket) {}
+			Accept(int error, const Shared<Socket>& pSocket) : Action("SocketAccept", error, pSocket) { lane = LANE_HIGH; }
 		private:
 			struct Handle : Action::Handle {
 				Handle(const char* name, const Shared<Socket>& pSocket, const Exception& ex, Shared<Socket>& pConnection, bool& stop) :
 					Action::Handle(name, pSocket, ex), _pConnection(move(pConnection)), _pThread(NULL) {
-					if (++pSocket->_receiving < Socket::BACKLOG_MAX)
+					if (++pSocket->_receiving < Socket::BACKLOG_MAX && !pSocket->_pHandler->saturated())
 						return;
 					stop = true;
 					_pThread = ThreadQueue::Current();
@@ -305,16 +1001,20 @@ void IOSocket::read(const Shared<Socket>& pSocket, int error) {
 				if (!pSocket->_reading--) // me and something else! useless!
 					return true;
 				Shared<Socket> pConnection;
+				vector<Shared<Runner>> handles; // queued at once to handler
 				bool stop(false);
 				do {
 					if (!pSocket->accept(ex, pConnection)) {
+						if (!handles.empty())
+							pSocket->_pHandler->queue(handles);
 						if (ex.cast<Ex::Net::Socket>().code != NET_EWOULDBLOCK)
 							return false;
 						ex = nullptr;
 						return true;
 					}
-					handle<Handle>(pSocket, pConnection, stop);
+					handle<Handle>(handles, pSocket, pConnection, stop);
 				} while (!stop);
+				pSocket->_pHandler->queue(handles);
 				return true;
 			}
 		};
@@ -329,7 +1029,8 @@ void IOSocket::read(const Shared<Socket>& pSocket, int error) {
 		struct Handle : Action::Handle {
 			Handle(const char* name, const Shared<Socket>& pSocket, const Exception& ex, Shared<Buffer>& pBuffer, const SocketAddress& address, bool& stop) :
 				Action::Handle(name, pSocket, ex), _address(address), _pBuffer(move(pBuffer)), _pThread(NULL) {
-				if ((pSocket->_receiving += _pBuffer->size()) < pSocket->recvBufferSize())
+				// stop reception if socket or handler backlog is too deep, rearmed when this handle is consumed
+				if ((pSocket->_receiving += _pBuffer->size()) < pSocket->recvBufferSize() && !pSocket->_pHandler->saturated())
 					return;
 				stop = true;
 				_pThread = ThreadQueue::Current();
@@ -351,18 +1052,81 @@ void IOSocket::read(const Shared<Socket>& pSocket, int error) {
 			SocketAddress		_address;
 			ThreadQueue*		_pThread;
 		};
+		/*!
+		Datagrams received in one batch, given to onReceived in one handler task */
+		struct Datagrams : Action::Handle {
+			Datagrams(const char* name, const Shared<Socket>& pSocket, const Exception& ex, vector<Socket::Datagram>& datagrams, uint32_t size, bool& stop) :
+				Action::Handle(name, pSocket, ex), _datagrams(move(datagrams)), _size(size), _pThread(NULL) {
+				// stop reception if socket or handler backlog is too deep, rearmed when this handle is consumed
+				if ((pSocket->_receiving += size) < pSocket->recvBufferSize() && !pSocket->_pHandler->saturated())
+					return;
+				stop = true;
+				_pThread = ThreadQueue::Current();
+				++pSocket->_reading;
+			}
+		private:
+			void handle(const Shared<Socket>& pSocket) {
+				for (Socket::Datagram& datagram : _datagrams) {
+					if (datagram.first)
+						pSocket->_onReceived(datagram.first, datagram.second);
+				}
+				uint32_t receiving = pSocket->_receiving -= _size;
+				if (!_pThread)
+					return;
+				if (receiving < pSocket->recvBufferSize())
+					_pThread->queue<Receive>(0, pSocket); // REARM
+				else
+					--pSocket->_reading;
+			}
+			vector<Socket::Datagram>	_datagrams;
+			uint32_t					_size;
+			ThreadQueue*				_pThread;
+		};
 
 		bool process(Exception& ex, const Shared<Socket>& pSocket) {
 			if (!pSocket->_reading--) // me and something else! useless!
 				return true;
 			bool stop(false);
+			if (pSocket->_recvBatch > 1) {
+				// recvmmsg, without available() call by datagram
+				vector<Socket::Datagram> datagrams(pSocket->_recvBatch);
+				while (!stop) {
+					int received = pSocket->receiveDatagrams(ex, datagrams.data(), uint16_t(datagrams.size()), pSocket->_recvBatchSize);
+					if (received < 0) {
+						if (ex.cast<Ex::Net::Socket>().code != NET_EWOULDBLOCK)
+							return false; // error, but not necessary a disconnection
+						ex = nullptr;
+						return true;
+					}
+					// move datagrams received, buffers remaining are reused on next reception
+					vector<Socket::Datagram> batch(make_move_iterator(datagrams.begin()), make_move_iterator(datagrams.begin() + received));
+					if (pSocket->_pDecoder)
+						pSocket->_pDecoder->decodeDatagrams(batch, pSocket);
+					uint32_t size(0), count(0);
+					for (const Socket::Datagram& datagram : batch) {
+						if (!datagram.first)
+							continue; // captured by decoder or lost
+						size += datagram.first->size();
+						++count;
+					}
+					if (count || ex) // ex => NET_EMSGSIZE, a datagram lost
+						handle<Datagrams>(pSocket, batch, size, stop);
+				}
+				return true;
+			}
 			while (!stop) {
 				uint32_t available = pSocket->available();
 				if (!available) // always get something (maybe a new reception has been gotten since the last pSocket->available() call)
 					available = 2048; // in UDP allows to avoid a NET_EMSGSIZE error (where packet is lost!), and 2048 to be greater than max possible MTU (~1500 bytes)
-				Shared<Buffer>	pBuffer(SET, available);
+				Shared<Buffer>	pBuffer;
+				uint32_t		size;
+				char* data = pSocket->_pRecvRing ? pSocket->_pRecvRing->write(size) : NULL;
+				if (data) // read directly all what the ring can take
+					available = size;
+				else // no ring or ring full
+					data = pBuffer.set(available).data();
 				SocketAddress	address;
-				int received = pSocket->receive(ex, pBuffer->data(), available, 0, &address);
+				int received = pSocket->receive(ex, data, available, 0, &address);
 				if (received < 0) {
 					if (ex.cast<Ex::Net::Socket>().code != NET_ESHUTDOWN) {
 						// if NET_EMSGSIZE => UDP packet lost! (can happen on windows! error displaid!)
@@ -382,7 +1146,10 @@ void IOSocket::read(const Shared<Socket>& pSocket, int error) {
 					return true;
 				}
 
-				pBuffer->resize(received);
+				if (pBuffer)
+					pBuffer->resize(received);
+				else
+					pBuffer = RingBuffer::Commit(pSocket->_pRecvRing, received); // view on ring, without copy
 
 				// decode can't happen BEFORE onDisconnection because this call decode + push to _handler in this call!
 				if (pSocket->_pDecoder)
@@ -394,6 +1161,8 @@ void IOSocket::read(const Shared<Socket>& pSocket, int error) {
 		}
 	};
 
+	if (pSocket->_reading == 1) // no reception pending (no REARM queued by handler), track can move if its thread is drained
+		threadPool.rebalance(pSocket->_threadReceive);
 	threadPool.queue<Receive>(pSocket->_threadReceive, error, pSocket);
 }
 
@@ -406,7 +1175,7 @@ void IOSocket::write(const Shared<Socket>& pSocket, int error) {
 	//::printf("WRITING(%d) socket %d\n", error, pSocket->id());
 
 	struct Send : Action {
-		Send(int error, const Shared<Socket>& pSocket) : Action("SocketSend", error, pSocket) {}
+		Send(int error, const Shared<Socket>& pSocket) : Action("SocketSend", error, pSocket) { lane = LANE_HIGH; }
 	private:
 		bool process(Exception& ex, const Shared<Socket>& pSocket) {
 			if (!pSocket->flush(ex))
@@ -436,7 +1205,7 @@ void IOSocket::close(const Shared<Socket>& pSocket, int error) {
 	//::printf("CLOSING(%d) socket %d\n", error, pSocket->id());
 
 	struct Close : Action {
-		Close(int error, const Shared<Socket>& pSocket) : Action("SocketClose", error, pSocket) {}
+		Close(int error, const Shared<Socket>& pSocket) : Action("SocketClose", error, pSocket) { lane = LANE_HIGH; }
 	private:
 		struct Handle : Action::Handle {
 			Handle(const char* name, const Shared<Socket>& pSocket, const Exception& ex) : Action::Handle(name, pSocket, ex) {}
@@ -457,8 +1226,42 @@ void IOSocket::close(const Shared<Socket>& pSocket, int error) {
 	threadPool.queue<Close>(pSocket->_threadReceive, error, pSocket);
 }
 
+#if !defined(_WIN32) && !defined(_BSD)
+void IOSocket::dispatch(const Shared<Socket>& pSocket, uint32_t events) {
+	// EPOLLIN | EPOLLOUT | EPOLLERR | EPOLLHUP | EPOLLRDHUP
+	//printf("%d => 0x%08x\n", pSocket->id(), events);
+	int error = 0;
+	if(events&EPOLLERR) {
+		socklen_t len(sizeof(error));
+		if(getsockopt(pSocket->id(), SOL_SOCKET, SO_ERROR, (void *)&error, &len)==-1)
+			error = Net::LastError();
+	}
+	if (events&EPOLLRDHUP) {
+		// disconnection
+		close(pSocket, error);
+		return;
+	}
+	if (!(events&EPOLLHUP)) { // if socket unexpected close no more read or write!
+		// EPOLLOUT in first to get the onFlush (onConnection for TCP) in first (before any reception)
+		if (events&EPOLLOUT) {
+			write(pSocket, error);
+			error = 0;
+		}
+		if (events&EPOLLIN) {
+			read(pSocket, error);
+			error = 0;
+		}
+	}
+	if (error) // on few unix system we can get an error without anything else
+		threadPool.queue<Action>(pSocket->_threadReceive, "SocketError", error, pSocket);
+}
+#endif
+
 
 bool IOSocket::run(Exception& ex, const volatile bool& requestStop) {
+#if !defined(MONA_IO_URING)
+	_backend = BACKEND_POLL; // io_uring unavailable on this platform
+#endif
 #if defined(_WIN32)
 	WNDCLASSEX wc;
 	::memset(&wc, 0, sizeof(wc));
@@ -489,8 +1292,26 @@ bool IOSocket::run(Exception& ex, const volatile bool& requestStop) {
         _system = kqueue();
 #else
 	epoll_event events[MAXEVENTS];
-	if(readFD>0 && _eventFD>0 && fcntl(readFD, F_SETFL, fcntl(readFD, F_GETFL, 0) | O_NONBLOCK)!=-1)
+#if defined(MONA_IO_URING)
+	Unique<Ring> pRing;
+#endif
+	if(readFD>0 && _eventFD>0 && fcntl(readFD, F_SETFL, fcntl(readFD, F_GETFL, 0) | O_NONBLOCK)!=-1) {
+#if defined(MONA_IO_URING)
+		if (_backend == BACKEND_IO_URING && IOUring::Available()) {
+			Exception exRing;
+			if (pRing.set(self, readFD).open(exRing))
+				_system = pRing->fd();
+			else {
+				WARN(name(), " falls back on epoll, ", exRing);
+				pRing.reset();
+			}
+		}
+		if (!pRing)
+			_backend = BACKEND_POLL;
+		if (!_system)
+#endif
 		_system = epoll_create(MAXEVENTS); // Argument is ignored on new system, otherwise must be >= to events[] size
+	}
 #endif
 	if(_system<=0) {
 		if(_eventFD>0)
@@ -504,12 +1325,17 @@ bool IOSocket::run(Exception& ex, const volatile bool& requestStop) {
 		struct kevent event;
         EV_SET(&event, readFD, EVFILT_READ, EV_ADD, 0, 0, NULL);
         kevent(_system, &event, 1, NULL, 0, NULL);
-#else    
-        epoll_event event;
-        memset(&event, 0, sizeof(event));
-        event.events = EPOLLIN;
-        event.data.fd = readFD;
-        epoll_ctl(_system, EPOLL_CTL_ADD,readFD, &event);
+#else
+#if defined(MONA_IO_URING)
+		if (!pRing) // else the ring polls readFD itself
+#endif
+		{
+			epoll_event event;
+			memset(&event, 0, sizeof(event));
+			event.events = EPOLLIN;
+			event.data.fd = readFD;
+			epoll_ctl(_system, EPOLL_CTL_ADD, readFD, &event);
+		}
 #endif
 	}
 #endif
@@ -581,6 +1407,10 @@ bool IOSocket::run(Exception& ex, const volatile bool& requestStop) {
 	}
 
 #else
+#if defined(MONA_IO_URING)
+	if (pRing)
+		return pRing->run(ex);
+#endif
 	vector<Weak<Socket>*>	removedSockets;
 
 	for (;;) {
@@ -657,32 +1487,7 @@ bool IOSocket::run(Exception& ex, const volatile bool& requestStop) {
 			Shared<Socket> pSocket(reinterpret_cast<Weak<Socket>*>(event.data.ptr)->lock());
 			if(!pSocket)
 				continue; // socket error
-			// EPOLLIN | EPOLLOUT | EPOLLERR | EPOLLHUP | EPOLLRDHUP
-			//printf("%d => 0x%08x\n", pSocket->id(), event.events);
-			int error = 0;
-			if(event.events&EPOLLERR) {
-				socklen_t len(sizeof(error));
-				if(getsockopt(pSocket->id(), SOL_SOCKET, SO_ERROR, (void *)&error, &len)==-1)
-					error = Net::LastError();
-			}
-			if (event.events&EPOLLRDHUP) {
-				// disconnection
-				close(pSocket, error);
-				continue;
-			}
-			if (!(event.events&EPOLLHUP)) { // if socket unexpected close no more read or write!
-				// EPOLLOUT in first to get the onFlush (onConnection for TCP) in first (before any reception)
-				if (event.events&EPOLLOUT) {
-					write(pSocket, error);
-					error = 0;
-				}
-				if (event.events&EPOLLIN) {
-					read(pSocket, error);
-					error = 0;
-				}
-			}
-			if (error) // on few unix system we can get an error without anything else
-				threadPool.queue<Action>(pSocket->_threadReceive, "SocketError", error, pSocket);
+			dispatch(pSocket, event.events);
 #endif
 		}
 
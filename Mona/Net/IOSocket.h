@@ -32,7 +32,43 @@ struct IOSocket : protected Thread, virtual Object {
 	const Handler&			handler;
 	const ThreadPool&		threadPool;
 
-	uint32_t					subscribers() const { return _subscribers; }
+	/*!
+	Sockets managed, by all reactors */
+	uint32_t				subscribers() const;
+
+	/*!
+	Number of reactors, threads of event system among which sockets are sharded, each one with its own epoll (or io_uring) instance, 1 by default.
+	A socket goes to the reactor managing the fewer sockets, and a listening socket to the reactor managing the fewer listening sockets
+	to get one listening socket by reactor when a server listens with SO_REUSEPORT (see TCPServer).
+	To set before the first subscription, reactors get backend and placement of this IOSocket */
+	uint16_t				reactors() const { return uint16_t(_reactors.size() + 1); }
+	IOSocket&				setReactors(uint16_t count);
+
+	/*!
+	Event system, BACKEND_POLL by default (epoll, kqueue or WSAAsyncSelect), BACKEND_IO_URING selects io_uring on Linux 6.0+
+	with multishot accept and receptions in buffers given by Buffer::Allocator (see BufferPool), without system call by packet.
+	To set before the first subscription, once started backend() returns the event system really used (BACKEND_POLL if io_uring is unavailable) */
+	enum Backend {
+		BACKEND_POLL = 0,
+		BACKEND_IO_URING
+	};
+	Backend					backend() const { return _backend; }
+	IOSocket&				setBackend(Backend backend);
+	/*!
+	Size of the reception buffers of datagrams with BACKEND_IO_URING, 64KB by default (a tier of Buffer::Allocator).
+	They get the recvmsg header and the address (44 bytes) before the payload, a greater datagram is lost with a NET_EMSGSIZE error.
+	Buffers are allocated on the first datagram socket subscription, small datagrams are copied out of them to not hold a whole buffer.
+	To lower to save memory of reception buffers when datagrams are small (MTU), to set before the first subscription */
+	uint32_t				datagramSize() const { return _datagramSize; }
+	IOSocket&				setDatagramSize(uint32_t size);
+
+	/*!
+	Placement of the epoll thread (see Thread), to configure before the first subscription */
+	using Thread::affinity;
+	using Thread::setAffinity;
+	using Thread::realTime;
+	using Thread::setRealTime;
+	using Thread::placement;
 
 	bool					subscribe(Exception& ex, const Shared<Socket>& pSocket,
 								const Socket::OnReceived& onReceived,
@@ -96,6 +132,17 @@ private:
 			const Socket::OnError& onError);
 	
 	virtual bool run(Exception& ex, const volatile bool& requestStop);
+	/*!
+	Reactor for pSocket, 0 for this IOSocket or index in _reactors + 1 */
+	uint16_t shard(const Socket& socket) const;
+#if !defined(_WIN32) && !defined(_BSD)
+	/*!
+	Dispatch epoll events of pSocket to read, write and close */
+	void dispatch(const Shared<Socket>& pSocket, uint32_t events);
+#endif
+	/*!
+	Rearm a reception paused by io_uring backend for backpressure */
+	void resume(Socket& socket);
 
 #if defined(_WIN32)
 	std::map<NET_SOCKET, Weak<Socket>>	_sockets;
@@ -106,8 +153,18 @@ private:
 
 	NET_SYSTEM									_system;
 	Shared<IOSRTSocket>							_pIOSRTSocket;
+	std::atomic<Backend>						_backend;
+	uint32_t									_datagramSize;
+	std::vector<Unique<IOSocket>>				_reactors; // reactors other than this one
+	std::atomic<uint32_t>						_listeners;
+
+	struct Link;
+	Shared<Link>								_pLink;
 
 	struct Action;
+	struct Received;
+	struct Accepted;
+	struct Ring;
 };
 
 
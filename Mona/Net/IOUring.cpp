@@ -0,0 +1,196 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#include "Mona/Net/IOUring.h"
+#if defined(MONA_IO_URING)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/utsname.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace Mona {
+
+bool IOUring::Available() {
+	static const bool Available([]() {
+		utsname name;
+		unsigned major(0), minor(0);
+		return uname(&name) == 0 && sscanf(name.release, "%u.%u", &major, &minor) == 2 && major >= 6;
+	}());
+	return Available;
+}
+
+bool IOUring::open(Exception& ex, uint32_t entries, uint32_t completions) {
+	close();
+	io_uring_params params;
+	memset(&params, 0, sizeof(params));
+	params.flags = IORING_SETUP_CQSIZE | IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_COOP_TASKRUN;
+	params.cq_entries = completions;
+	if ((_fd = syscall(__NR_io_uring_setup, entries, &params)) < 0 && errno == EINVAL) {
+		// flags unsupported (SINGLE_ISSUER requires Linux 6.0)
+		params.flags = IORING_SETUP_CQSIZE;
+		_fd = syscall(__NR_io_uring_setup, entries, &params);
+	}
+	if (_fd < 0) {
+		ex.set<Ex::Net::System>("io_uring_setup failed (error ", errno, ")");
+		return false;
+	}
+	if (!(params.features & IORING_FEAT_SINGLE_MMAP) || !(params.features & IORING_FEAT_NODROP)) {
+		close();
+		ex.set<Ex::Unsupported>("io_uring without single mmap or nodrop feature");
+		return false;
+	}
+	_sqSize = _cqSize = max(params.sq_off.array + params.sq_entries * sizeof(uint32_t), params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe));
+	_pSQ = mmap(NULL, _sqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_SQ_RING);
+	if (_pSQ == MAP_FAILED) {
+		_pSQ = NULL;
+		close();
+		ex.set<Ex::Net::System>("io_uring ring mapping failed (error ", errno, ")");
+		return false;
+	}
+	_pCQ = _pSQ; // single mmap
+	_sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+	_pSQEs = (io_uring_sqe*)mmap(NULL, _sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_SQES);
+	if (_pSQEs == MAP_FAILED) {
+		_pSQEs = NULL;
+		close();
+		ex.set<Ex::Net::System>("io_uring entries mapping failed (error ", errno, ")");
+		return false;
+	}
+	char* pSQ((char*)_pSQ);
+	_sqHead = (uint32_t*)(pSQ + params.sq_off.head);
+	_sqTail = (uint32_t*)(pSQ + params.sq_off.tail);
+	_sqMask = *(uint32_t*)(pSQ + params.sq_off.ring_mask);
+	_sqArray = (uint32_t*)(pSQ + params.sq_off.array);
+	for (uint32_t i = 0; i < params.sq_entries; ++i)
+		_sqArray[i] = i; // identity, entry i is always at index i
+	char* pCQ((char*)_pCQ);
+	_cqHead = (uint32_t*)(pCQ + params.cq_off.head);
+	_cqTail = (uint32_t*)(pCQ + params.cq_off.tail);
+	_cqMask = *(uint32_t*)(pCQ + params.cq_off.ring_mask);
+	_cqes = (io_uring_cqe*)(pCQ + params.cq_off.cqes);
+	_pending = 0;
+	return true;
+}
+
+void IOUring::close() {
+	if (_fd >= 0) {
+		::close(_fd); // releases operations and buffer rings registered
+		_fd = -1;
+	}
+	for (Unique<Group>& pGroup : _groups) {
+		if (pGroup && pGroup->pRing)
+			munmap(pGroup->pRing, (pGroup->mask + 1) * sizeof(io_uring_buf));
+	}
+	_groups.clear();
+	if (_pSQEs) {
+		munmap(_pSQEs, _sqesSize);
+		_pSQEs = NULL;
+	}
+	if (_pSQ) {
+		munmap(_pSQ, _sqSize);
+		_pSQ = _pCQ = NULL;
+	}
+}
+
+io_uring_sqe* IOUring::prepare(uint8_t opcode, int fd, uint64_t userData) {
+	uint32_t tail(*_sqTail);
+	while (tail - __atomic_load_n(_sqHead, __ATOMIC_ACQUIRE) > _sqMask) {
+		// full
+		if (submit() < 0)
+			return NULL;
+	}
+	io_uring_sqe* pSQE(&_pSQEs[tail & _sqMask]);
+	memset(pSQE, 0, sizeof(io_uring_sqe));
+	pSQE->opcode = opcode;
+	pSQE->fd = fd;
+	pSQE->user_data = userData;
+	__atomic_store_n(_sqTail, tail + 1, __ATOMIC_RELEASE);
+	++_pending;
+	return pSQE;
+}
+
+int IOUring::submit(uint32_t wait) {
+	// publish buffers given back
+	for (Unique<Group>& pGroup : _groups) {
+		if (pGroup)
+			__atomic_store_n(&pGroup->pRing->tail, pGroup->tail, __ATOMIC_RELEASE);
+	}
+	int result(syscall(__NR_io_uring_enter, _fd, _pending, wait, wait ? IORING_ENTER_GETEVENTS : 0, NULL, 0));
+	if (result < 0)
+		return -errno;
+	_pending -= min(uint32_t(result), _pending);
+	return result;
+}
+
+io_uring_cqe* IOUring::completion() {
+	uint32_t head(*_cqHead);
+	if (head == __atomic_load_n(_cqTail, __ATOMIC_ACQUIRE))
+		return NULL;
+	return &_cqes[head & _cqMask];
+}
+
+bool IOUring::provide(Exception& ex, uint16_t group, uint16_t count, uint32_t size) {
+	if (_groups.size() <= group)
+		_groups.resize(group + 1);
+	Group& buffers(_groups[group].set());
+	size_t ringSize(count * sizeof(io_uring_buf));
+	void* pRing(mmap(NULL, ringSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+	if (pRing == MAP_FAILED) {
+		_groups[group].reset();
+		ex.set<Ex::Net::System>("io_uring buffer ring allocation failed (error ", errno, ")");
+		return false;
+	}
+	buffers.pRing = (io_uring_buf_ring*)pRing;
+	buffers.mask = count - 1;
+	buffers.size = size;
+	io_uring_buf_reg reg;
+	memset(&reg, 0, sizeof(reg));
+	reg.ring_addr = uint64_t(pRing);
+	reg.ring_entries = count;
+	reg.bgid = group;
+	if (syscall(__NR_io_uring_register, _fd, IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+		ex.set<Ex::Net::System>("io_uring buffer ring registration failed (error ", errno, ")");
+		munmap(pRing, ringSize);
+		_groups[group].reset();
+		return false;
+	}
+	buffers.buffers.resize(count);
+	for (uint16_t id = 0; id < count; ++id)
+		give(buffers, id);
+	return true;
+}
+
+Shared<Buffer> IOUring::take(uint16_t group, uint16_t id) {
+	Group& buffers(*_groups[group]);
+	Shared<Buffer> pBuffer(move(buffers.buffers[id]));
+	give(buffers, id);
+	return pBuffer;
+}
+
+void IOUring::give(Group& group, uint16_t id) {
+	Buffer& buffer(group.buffers[id].set(group.size));
+	// not pRing->bufs, its flexible array declaration is shifted in C++ (empty struct of size 1 before it)
+	io_uring_buf& entry(((io_uring_buf*)group.pRing)[group.tail++ & group.mask]);
+	entry.addr = uint64_t(buffer.data());
+	entry.len = group.size;
+	entry.bid = id;
+}
+
+} // namespace Mona
+
+#endif
@@ -0,0 +1,102 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#pragma once
+
+#include "Mona/Mona.h"
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define MONA_IO_URING 1
+#endif
+#endif
+
+#if defined(MONA_IO_URING)
+#include "Mona/Memory/Buffer.h"
+#include "Mona/Util/Exceptions.h"
+#include <linux/io_uring.h>
+#include <vector>
+
+namespace Mona {
+
+/*!
+Minimal io_uring on raw system calls (no liburing dependency) for IOSocket, with provided buffer rings.
+Single issuer: the thread which opens it must be the only one to prepare, submit and consume */
+struct IOUring : virtual Object {
+	IOUring() : _fd(-1), _pSQ(NULL), _pCQ(NULL), _pSQEs(NULL), _sqSize(0), _cqSize(0), _sqesSize(0), _pending(0) {}
+	~IOUring() { close(); }
+
+	/*!
+	True if the kernel offers what IOSocket requires (multishot accept/recv/recvmsg and provided buffer rings, Linux 6.0) */
+	static bool		Available();
+
+	bool			open(Exception& ex, uint32_t entries, uint32_t completions);
+	void			close();
+	int				fd() const { return _fd; }
+
+	/*!
+	Next submission entry, zeroed and filled with opcode, fd and userData, submits prepared entries if the queue is full */
+	io_uring_sqe*	prepare(uint8_t opcode, int fd, uint64_t userData);
+	/*!
+	Submit prepared entries and wait at least wait completions, returns -errno on error */
+	int				submit(uint32_t wait = 0);
+	/*!
+	Next completion, NULL if nothing, to release with next() */
+	io_uring_cqe*	completion();
+	void			next() { __atomic_store_n(_cqHead, *_cqHead + 1, __ATOMIC_RELEASE); }
+
+	/*!
+	Provide count buffers (power of two) of size bytes to the kernel as buffer group, allocated by Buffer::Allocator (see BufferPool) */
+	bool			provide(Exception& ex, uint16_t group, uint16_t count, uint32_t size);
+	/*!
+	Take the buffer id of group filled by the kernel, a new buffer replaces it in the ring on the next submit */
+	Shared<Buffer>	take(uint16_t group, uint16_t id);
+
+private:
+	struct Group : virtual Object {
+		Group() : pRing(NULL), mask(0), tail(0), size(0) {}
+		io_uring_buf_ring*			pRing;
+		uint16_t					mask;
+		uint16_t					tail; // local tail, published on submit
+		uint32_t					size;
+		std::vector<Shared<Buffer>>	buffers; // by id
+	};
+	void	give(Group& group, uint16_t id);
+
+	int					_fd;
+	void*				_pSQ;
+	void*				_pCQ;
+	io_uring_sqe*		_pSQEs;
+	size_t				_sqSize;
+	size_t				_cqSize;
+	size_t				_sqesSize;
+	// submission ring
+	uint32_t*			_sqHead;
+	uint32_t*			_sqTail;
+	uint32_t			_sqMask;
+	uint32_t*			_sqArray;
+	uint32_t			_pending; // prepared and not submitted
+	// completion ring
+	uint32_t*			_cqHead;
+	uint32_t*			_cqTail;
+	uint32_t			_cqMask;
+	io_uring_cqe*		_cqes;
+
+	std::vector<Unique<Group>>	_groups;
+};
+
+} // namespace Mona
+
+#endif
@@ -88,6 +88,7 @@ struct SRT : virtual Object {
 		bool connect(Exception& ex, const SocketAddress& address, uint16_t timeout = 0) override;
 
 		int	 sendTo(Exception& ex, const char* data, uint32_t size, const SocketAddress& address, int flags = 0) override;
+		int	 sendTo(Exception& ex, const PacketList& packets, const SocketAddress& address, int flags = 0) override { return sendJoined(ex, packets, address, flags); }
 
 		bool bind(Exception& ex, const SocketAddress& address) override;
 
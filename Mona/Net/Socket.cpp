@@ -19,6 +19,7 @@ details (or else see http://mozilla.org/MPL/2.0/).
 #if !defined(_WIN32)
 #include <net/if.h>
 #include <fcntl.h>
+#include <sys/uio.h>
 #endif
 
 
@@ -30,7 +31,7 @@ Socket::Socket(Type type) :
 #if !defined(_WIN32)
 	_pWeakThis(NULL), 
 #endif
-	_opened(false), _pDecoder(NULL), _externDecoder(false), _nonBlockingMode(false), _listening(false), _receiving(0), _queueing(0), _recvBufferSize(Net::GetRecvBufferSize()), _sendBufferSize(Net::GetSendBufferSize()), _reading(0), _sending(false), type(type), _recvTime(0), _sendTime(0), _id(NET_INVALID_SOCKET), _threadReceive(0),
+	_opened(false), _pDecoder(NULL), _externDecoder(false), _nonBlockingMode(false), _listening(false), _receiving(0), _queueing(0), _recvBufferSize(Net::GetRecvBufferSize()), _sendBufferSize(Net::GetSendBufferSize()), _reading(0), _sending(false), type(type), _recvTime(0), _sendTime(0), _id(NET_INVALID_SOCKET), _threadReceive(0), _reactor(0), _recvBatch(0), _recvBatchSize(0),
 	onError(_onError) {
 
 	if (type < TYPE_OTHER) {
@@ -48,7 +49,7 @@ Socket::Socket(NET_SOCKET id, const sockaddr& addr, Type type) : _peerAddress(ad
 #if !defined(_WIN32)
 	_pWeakThis(NULL),
 #endif
-	_opened(false), _pDecoder(NULL), _externDecoder(false), _nonBlockingMode(false), _listening(false), _receiving(0), _queueing(0), _recvBufferSize(Net::GetRecvBufferSize()), _sendBufferSize(Net::GetSendBufferSize()), _reading(0), _sending(false), type(type), _recvTime(Time::Now()), _sendTime(0), _id(id), _threadReceive(0),
+	_opened(false), _pDecoder(NULL), _externDecoder(false), _nonBlockingMode(false), _listening(false), _receiving(0), _queueing(0), _recvBufferSize(Net::GetRecvBufferSize()), _sendBufferSize(Net::GetSendBufferSize()), _reading(0), _sending(false), type(type), _recvTime(Time::Now()), _sendTime(0), _id(id), _threadReceive(0), _reactor(0), _recvBatch(0), _recvBatchSize(0),
 	onError(_onError) {
 
 	if (type < TYPE_OTHER)
@@ -142,6 +143,26 @@ bool Socket::setRecvBufferSize(Exception& ex, uint32_t size) {
 	_recvBufferSize = size;
 	return true;
 }
+bool Socket::setRecvRing(Exception& ex, uint32_t size) {
+	if (type != TYPE_STREAM) {
+		ex.set<Ex::Unsupported>("Receive ring buffer requires a stream socket");
+		return false;
+	}
+	if (size)
+		_pRecvRing.set(size);
+	else
+		_pRecvRing.reset();
+	return true;
+}
+bool Socket::setRecvBatch(Exception& ex, uint16_t count, uint32_t size) {
+	if (type != TYPE_DATAGRAM) {
+		ex.set<Ex::Unsupported>("Batched reception requires a datagram socket");
+		return false;
+	}
+	_recvBatch = min<uint16_t>(count, 64);
+	_recvBatchSize = size;
+	return true;
+}
 bool Socket::setSendBufferSize(Exception& ex, uint32_t size) {
 	if (!setOption(ex, SOL_SOCKET, SO_SNDBUF, size))
 		return false;
@@ -442,6 +463,71 @@ int Socket::receive(Exception& ex, char* buffer, uint32_t size, int flags, Socke
 	return rc;
 }
 
+int Socket::receiveDatagrams(Exception& ex, Datagram* datagrams, uint16_t count, uint32_t size) {
+#if defined(__linux__)
+	if (_ex) {
+		ex = _ex;
+		return -1;
+	}
+	mmsghdr messages[64];
+	iovec	iovecs[64];
+	union {
+		struct sockaddr_in  sa_in;
+		struct sockaddr_in6 sa_in6;
+	} addresses[64];
+	if (count > 64)
+		count = 64;
+	memset(messages, 0, count * sizeof(mmsghdr));
+	for (uint16_t i = 0; i < count; ++i) {
+		Shared<Buffer>& pBuffer(datagrams[i].first);
+		if (!pBuffer)
+			pBuffer.set(size);
+		iovecs[i].iov_base = pBuffer->data();
+		iovecs[i].iov_len = pBuffer->size();
+		messages[i].msg_hdr.msg_iov = &iovecs[i];
+		messages[i].msg_hdr.msg_iovlen = 1;
+		messages[i].msg_hdr.msg_name = &addresses[i];
+		messages[i].msg_hdr.msg_namelen = sizeof(addresses[i]);
+	}
+	int rc;
+	int error;
+	do {
+		rc = ::recvmmsg(_id, messages, count, 0, NULL);
+	} while (rc < 0 && (error = Net::LastError()) == NET_EINTR);
+	if (rc < 0) {
+		SetException(error, ex, " (size=", size, ", count=", count, ")");
+		return -1;
+	}
+
+	if (!_address)
+		_address.set(IPAddress::Loopback(), 0); // to advise that address is computable
+
+	uint32_t received(0);
+	for (int i = 0; i < rc; ++i) {
+		Datagram& datagram(datagrams[i]);
+		datagram.second.set(reinterpret_cast<const sockaddr&>(addresses[i]));
+		received += messages[i].msg_len;
+		if (messages[i].msg_hdr.msg_flags & MSG_TRUNC) {
+			// datagram lost, as NET_EMSGSIZE of recvfrom on windows
+			datagram.first.reset();
+			SetException(NET_EMSGSIZE, ex, " (from=", datagram.second, ", size=", size, ")");
+		} else
+			datagram.first->resize(messages[i].msg_len);
+	}
+	receive(received);
+	return rc;
+#else
+	Shared<Buffer>& pBuffer(datagrams->first);
+	if (!pBuffer)
+		pBuffer.set(size);
+	int received = receive(ex, pBuffer->data(), pBuffer->size(), 0, &datagrams->second);
+	if (received < 0)
+		return -1;
+	pBuffer->resize(received);
+	return 1;
+#endif
+}
+
 int Socket::sendTo(Exception& ex, const char* data, uint32_t size, const SocketAddress& address, int flags) {
 	if (_ex) {
 		ex = _ex;
@@ -478,6 +564,92 @@ int Socket::sendTo(Exception& ex, const char* data, uint32_t size, const SocketA
 	return rc;
 }
 
+int Socket::sendTo(Exception& ex, const PacketList& packets, const SocketAddress& address, int flags) {
+	if (packets.count() <= 1) // no gather required
+		return sendTo(ex, packets ? packets.front().data() : NULL, packets.size(), address, flags);
+	if (_ex) {
+		ex = _ex;
+		return -1;
+	}
+
+#if defined(MSG_NOSIGNAL)
+	flags |= MSG_NOSIGNAL;
+#endif
+
+	int rc;
+	int error;
+#if defined(_WIN32)
+	vector<WSABUF> buffers(packets.count());
+	uint32_t i(0);
+	for (const Packet& packet : packets) {
+		buffers[i].buf = (CHAR*)packet.data();
+		buffers[i++].len = packet.size();
+	}
+	DWORD sent;
+	const sockaddr* pAddress = type == TYPE_DATAGRAM && address ? address.data() : NULL; // for TCP socket, address must be null!
+	do {
+		rc = ::WSASendTo(_id, buffers.data(), buffers.size(), &sent, flags, pAddress, pAddress ? address.size() : 0, NULL, NULL) ? -1 : int(sent);
+	} while (rc < 0 && (error = Net::LastError()) == NET_EINTR);
+#else
+	iovec  stack[64];
+	vector<iovec> heap;
+	iovec* iovecs = packets.count() <= 64 ? stack : (heap.resize(packets.count()), heap.data());
+	uint32_t i(0);
+	for (const Packet& packet : packets) {
+		iovecs[i].iov_base = (void*)packet.data();
+		iovecs[i++].iov_len = packet.size();
+	}
+	msghdr message;
+	memset(&message, 0, sizeof(message));
+	message.msg_iov = iovecs;
+	message.msg_iovlen = packets.count();
+	if (type == TYPE_DATAGRAM && address) { // for TCP socket, address must be null!
+		message.msg_name = (void*)address.data();
+		message.msg_namelen = address.size();
+	}
+	do {
+		rc = ::sendmsg(_id, &message, flags);
+	} while (rc < 0 && (error = Net::LastError()) == NET_EINTR);
+#endif
+	if (rc < 0) {
+		SetException(error, ex, " (address=", address ? address : _peerAddress, ", size=", packets.size(), ", count=", packets.count(), ", flags=", flags, ")");
+		return -1;
+	}
+
+	if (!_address)
+		_address.set(IPAddress::Loopback(), 0); // to advise that address is computable
+
+	send(rc);
+
+	if (uint32_t(rc) < packets.size() && type == TYPE_DATAGRAM) {
+		SetException(NET_EMSGSIZE, ex, " (address=", address ? address : _peerAddress, ", size=", packets.size(), ", count=", packets.count(), ", flags=", flags, ")");
+		return -1;
+	}
+
+	return rc;
+}
+
+int Socket::sendJoined(Exception& ex, const PacketList& packets, const SocketAddress& address, int flags) {
+	if (packets.count() <= 1)
+		return sendTo(ex, packets ? packets.front().data() : NULL, packets.size(), address, flags);
+	Buffer buffer(packets.size());
+	return sendTo(ex, packets.copy(buffer.data()), buffer.size(), address, flags);
+}
+
+bool Socket::queueable(Exception& ex) {
+	int code = ex.cast<Ex::Net::Socket>().code;
+	if ((code == NET_ENOTCONN && _peerAddress) || code == NET_EWOULDBLOCK) {
+		// queue and wait next call to flush(), no error!
+		ex = nullptr;
+		return true;
+	}
+	// RELIABILITY IMPOSSIBLE => is not an error socket + is not connected (connecting = (peerAddress && error==NET_ENOTCONN) = false) + is not WOUldBLOCK
+	if (type == TYPE_STREAM) // else udp socket which send a packet without destinator address
+		close(); // shutdown system to avoid to try to send before shutdown!
+	_sending = false;
+	return false;
+}
+
 int Socket::write(Exception& ex, const Packet& packet, const SocketAddress& address, int flags) {
 	lock_guard<mutex> lock(_mutexSending);
 	if(!_sendings.empty()) {
@@ -488,18 +660,9 @@ int Socket::write(Exception& ex, const Packet& packet, const SocketAddress& addr
 	_sending = true;
 	int	sent = sendTo(ex, packet.data(), packet.size(), address);
 	if (sent < 0) {
-		int code = ex.cast<Ex::Net::Socket>().code;
-		if ((code == NET_ENOTCONN && _peerAddress) || code == NET_EWOULDBLOCK) {
-			// queue and wait next call to flush(), no error!
-			ex = nullptr;
-			sent = 0;
-		} else {
-			// RELIABILITY IMPOSSIBLE => is not an error socket + is not connected (connecting = (peerAddress && error==NET_ENOTCONN) = false) + is not WOUldBLOCK
-			if (type == TYPE_STREAM) // else udp socket which send a packet without destinator address
-				close(); // shutdown system to avoid to try to send before shutdown!
-			_sending = false;
+		if (!queueable(ex))
 			return -1;
-		}
+		sent = 0;
 	} else if (uint32_t(sent) >= packet.size()) {
 		_sending = false;
 		return packet.size();
@@ -510,6 +673,93 @@ int Socket::write(Exception& ex, const Packet& packet, const SocketAddress& addr
 	return sent;
 }
 
+int Socket::write(Exception& ex, const PacketList& packets, const SocketAddress& address, int flags) {
+	lock_guard<mutex> lock(_mutexSending);
+	int sent(0);
+	if (_sendings.empty()) {
+		_sending = true;
+		sent = sendTo(ex, packets, address, flags);
+		if (sent < 0) {
+			if (!queueable(ex))
+				return -1;
+			sent = 0;
+		} else if (uint32_t(sent) >= packets.size()) {
+			_sending = false;
+			return packets.size();
+		}
+	}
+	if (type != TYPE_STREAM && packets.count() > 1) {
+		// packets make one datagram, queue them joined
+		Shared<Buffer> pBuffer(SET, packets.size());
+		packets.copy(pBuffer->data());
+		_sendings.emplace_back(Packet(move(pBuffer)), address ? address : _peerAddress, flags);
+		_queueing += packets.size();
+		return sent;
+	}
+	uint32_t offset(sent);
+	for (const Packet& packet : packets) {
+		if (offset >= packet.size()) {
+			offset -= packet.size(); // already sent
+			continue;
+		}
+		_sendings.emplace_back(packet + offset, address ? address : _peerAddress, flags);
+		_queueing += _sendings.back().size();
+		offset = 0;
+	}
+	return sent;
+}
+
+int Socket::sendDatagrams(Exception& ex, uint32_t count) {
+#if defined(__linux__)
+	if (_ex) {
+		ex = _ex;
+		return -1;
+	}
+	int flags(_sendings.front().flags);
+#if defined(MSG_NOSIGNAL)
+	flags |= MSG_NOSIGNAL;
+#endif
+	mmsghdr messages[64];
+	iovec	iovecs[64];
+	if (count > 64)
+		count = 64;
+	memset(messages, 0, count * sizeof(mmsghdr));
+	for (uint32_t i = 0; i < count; ++i) {
+		const Sending& sending(_sendings[i]);
+		iovecs[i].iov_base = (void*)sending.data();
+		iovecs[i].iov_len = sending.size();
+		messages[i].msg_hdr.msg_iov = &iovecs[i];
+		messages[i].msg_hdr.msg_iovlen = 1;
+		if (sending.address) {
+			messages[i].msg_hdr.msg_name = (void*)sending.address.data();
+			messages[i].msg_hdr.msg_namelen = sending.address.size();
+		}
+	}
+	int rc;
+	int error;
+	do {
+		rc = ::sendmmsg(_id, messages, count, flags);
+	} while (rc < 0 && (error = Net::LastError()) == NET_EINTR);
+	if (rc < 0) {
+		const Sending& sending(_sendings.front());
+		SetException(error, ex, " (address=", sending.address ? sending.address : _peerAddress, ", size=", sending.size(), ", count=", count, ", flags=", flags, ")");
+		return -1;
+	}
+
+	if (!_address)
+		_address.set(IPAddress::Loopback(), 0); // to advise that address is computable
+
+	uint32_t sent(0);
+	for (int i = 0; i < rc; ++i)
+		sent += messages[i].msg_len;
+	send(sent);
+	return rc;
+#else
+	const Sending& sending(_sendings.front());
+	return sendTo(ex, sending.data(), sending.size(), sending.address, sending.flags) < 0 ? -1 : 1;
+#endif
+}
+
 bool Socket::flush(Exception& ex, bool deleting) {
 	uint32_t written(0);
 
@@ -519,12 +769,36 @@ bool Socket::flush(Exception& ex, bool deleting) {
 	int sent(0);
 	while(sent>=0 && !_sendings.empty()) {
 		Sending& sending(_sendings.front());
-		sent = sendTo(ex, sending.data(), sending.size(), sending.address, sending.flags);
+		uint32_t count(1), size(sending.size());
+		if (type == TYPE_STREAM && _sendings.size() > 1) {
+			// gather following sendings with the same flags in one system call
+			PacketList packets;
+			for (count = 0; count < _sendings.size() && count < 64 && _sendings[count].flags == sending.flags; ++count)
+				packets.append(_sendings[count]);
+			size = packets.size();
+			sent = sendTo(ex, packets, sending.address, sending.flags);
+		} else if (type == TYPE_DATAGRAM && _sendings.size() > 1) {
+			// send following datagrams with the same flags in one system call
+			for (count = 1; count < _sendings.size() && count < 64 && _sendings[count].flags == sending.flags; ++count);
+			if ((sent = sendDatagrams(ex, count)) >= 0) {
+				// datagrams are sent entirely, the remaining ones (if any) will be retried to get their error
+				for (count = sent, sent = 0; count--; _sendings.pop_front())
+					sent += _sendings.front().size();
+				written += sent;
+				continue;
+			}
+			count = 1; // error on the first datagram, skip it as a single sendTo does
+		} else
+			sent = sendTo(ex, sending.data(), sending.size(), sending.address, sending.flags);
 		if (sent >= 0) {
 			written += sent;
-			if (uint32_t(sent) < sending.size()) {
+			if (uint32_t(sent) < size) {
 				// can't send more!
-				sending += sent;
+				while (uint32_t(sent) >= _sendings.front().size()) { // sendings fully sent
+					sent -= _sendings.front().size();
+					_sendings.pop_front();
+				}
+				_sendings.front() += sent;
 				break;
 			}
 		} else {
@@ -539,7 +813,8 @@ bool Socket::flush(Exception& ex, bool deleting) {
 				return false;
 			}
 		}
-		_sendings.pop_front();
+		while (count--)
+			_sendings.pop_front();
 	}
 	if (!deleting && written && !(_queueing -= written))
 		_sending = false;
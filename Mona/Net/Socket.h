@@ -19,7 +19,8 @@ details (or else see http://mozilla.org/MPL/2.0/).
 #include "Mona/Mona.h"
 #include "Mona/Net/SocketAddress.h"
 #include "Mona/Util/ByteRate.h"
-#include "Mona/Memory/Packet.h"
+#include "Mona/Memory/PacketList.h"
+#include "Mona/Memory/RingBuffer.h"
 #include "Mona/Threading/Handler.h"
 #include "Mona/Util/Parameters.h"
 #include <deque>
@@ -33,12 +34,22 @@ struct Socket : virtual Object, Net::Stats {
 	typedef Event<void()>														  OnFlush;
 	typedef Event<void()>														  OnDisconnection;
 
+	/*!
+	Datagram received with its sender address (see setRecvBatch) */
+	typedef std::pair<Shared<Buffer>, SocketAddress>							  Datagram;
+
 	/*!
 	Decoder offers to decode data in the reception thread when socket is used with IOSocket
 	If pBuffer is reseted, no onReceived is callen (data captured),
 	/!\ pSocket must never be "attached" to the decoder in a instance variable otherwise a memory leak could happen (however a weak attachment stays acceptable) */
 	struct Decoder : virtual Object {
 		virtual void decode(Shared<Buffer>& pBuffer, const SocketAddress& address, const Shared<Socket>& pSocket) = 0;
+		/*!
+		Decode datagrams received in one batch (see setRecvBatch), by default decode them one by one, a datagram whose buffer is reseted is not delivered */
+		virtual void decodeDatagrams(std::vector<Datagram>& datagrams, const Shared<Socket>& pSocket) {
+			for (Datagram& datagram : datagrams)
+				decode(datagram.first, datagram.second, pSocket);
+		}
 		virtual void onRelease(Socket& socket) {}
 	};
 
@@ -93,6 +104,19 @@ struct Socket : virtual Object, Net::Stats {
 	virtual bool setRecvBufferSize(Exception& ex, uint32_t size);
 	virtual bool getRecvBufferSize(Exception& ex, uint32_t& size) const { return getOption(ex, SOL_SOCKET, SO_RCVBUF, size); }
 
+	/*!
+	Receive in a ring buffer of size bytes rather than in a new buffer on every read, 0 to disable (default), for a stream socket before its subscription.
+	Buffers received are views on the ring without allocation (see RingBuffer), if the ring is full (views still held) reception falls back on allocated buffers */
+	bool setRecvRing(Exception& ex, uint32_t size);
+	uint32_t recvRing() const { return _pRecvRing ? _pRecvRing->capacity() : 0; }
+
+	/*!
+	Receive until count datagrams (64 max) by system call (recvmmsg on Linux) in buffers of size bytes, 0 or 1 to disable (default), for a datagram socket before its subscription.
+	Datagrams of a batch are decoded together (see Decoder::decodeDatagrams) and given to onReceived in one handler task,
+	a datagram greater than size is lost with a NET_EMSGSIZE error. Without effect with BACKEND_IO_URING which receives already without system call by datagram */
+	bool setRecvBatch(Exception& ex, uint16_t count, uint32_t size = 2048);
+	uint16_t recvBatch() const { return _recvBatch; }
+
 	bool setNoDelay(Exception& ex, bool value) { return setOption(ex,IPPROTO_TCP, TCP_NODELAY, value ? 1 : 0); }
 	bool getNoDelay(Exception& ex, bool& value) const { return getOption(ex, IPPROTO_TCP, TCP_NODELAY, value); }
 
@@ -139,13 +163,24 @@ struct Socket : virtual Object, Net::Stats {
 
 	int			 send(Exception& ex, const char* data, uint32_t size, int flags = 0) { return sendTo(ex, data, size, SocketAddress::Wildcard(), flags); }
 	virtual int	 sendTo(Exception& ex, const char* data, uint32_t size, const SocketAddress& address, int flags=0);
+	/*!
+	Gather sending of packets in one system call (sendmsg), for a datagram socket packets make one datagram.
+	A Socket implementation which overrides sendTo has to override this one too (see sendJoined) */
+	virtual int	 sendTo(Exception& ex, const PacketList& packets, const SocketAddress& address, int flags = 0);
 
 	/*!
 	Sequential and safe writing, can queue data if can't send immediatly (flush required on onFlush event)
 	Returns size of data sent immediatly (or -1 if error, for TCP socket a SHUTDOWN_SEND is done, so socket will be disconnected) */
 	int			 write(Exception& ex, const Packet& packet, int flags = 0) { return write(ex, packet, SocketAddress::Wildcard(), flags); }
 	int			 write(Exception& ex, const Packet& packet, const SocketAddress& address, int flags = 0);
+	/*!
+	Write packets with gather sending, on a stream socket pending packets are also flushed by gather sending */
+	int			 write(Exception& ex, const PacketList& packets, int flags = 0) { return write(ex, packets, SocketAddress::Wildcard(), flags); }
+	int			 write(Exception& ex, const PacketList& packets, const SocketAddress& address, int flags = 0);
 
+	/*!
+	Send pending data, by gather sending on a stream socket, by batch of datagrams on a datagram socket (sendmmsg on Linux),
+	so a datagram Socket implementation which overrides sendTo has to override flush too */
 	bool		 flush(Exception& ex) { return flush(ex, false); }
 
 	template <typename ...Args>
@@ -165,12 +200,19 @@ protected:
 	Socket(NET_SOCKET id, const sockaddr& addr, Type type=TYPE_STREAM);
 	virtual Socket* newSocket(Exception& ex, NET_SOCKET sockfd, const sockaddr& addr) { return new Socket(sockfd, (sockaddr&)addr); }
 	virtual int		receive(Exception& ex, char* buffer, uint32_t size, int flags, SocketAddress* pAddress);
+	/*!
+	Receive until count datagrams in one system call (recvmmsg on Linux, one receive elsewhere), a datagram without buffer gets a new one of size bytes.
+	Returns the number of datagrams received, a truncated datagram has its buffer reseted and sets a NET_EMSGSIZE error in ex */
+	virtual int		receiveDatagrams(Exception& ex, Datagram* datagrams, uint16_t count, uint32_t size);
 
 
 	void			send(uint32_t count) { _sendTime = Time::Now(); _sendByteRate += count; }
 	void			receive(uint32_t count) { _recvTime = Time::Now(); _recvByteRate += count; }
 	virtual bool	flush(Exception& ex, bool deleting);
 	virtual bool	close(ShutdownType type = SHUTDOWN_BOTH) { return ::shutdown(_id, type) == 0; }
+	/*!
+	Send packets joined in one contiguous area of data with sendTo, for a Socket implementation without gather sending */
+	int				sendJoined(Exception& ex, const PacketList& packets, const SocketAddress& address, int flags);
 
 	template<typename Type, typename = typename std::enable_if<std::is_arithmetic<Type>::value && !std::is_same<Type, bool>::value>::type>
 	bool processParam(const Parameters& parameters, const char* name, Type& value, const char* prefix = NULL) {
@@ -192,6 +234,12 @@ protected:
 private:
 	virtual bool setIPV6Only(Exception& ex, bool enable) { return setOption(ex, IPPROTO_IPV6, IPV6_V6ONLY, enable ? 1 : 0); }
 	virtual void computeAddress();
+	/*!
+	On write error returns true if data can be queued to wait the next flush (connecting or would block), otherwise closes a stream socket */
+	bool		 queueable(Exception& ex);
+	/*!
+	Send the count first sendings, datagrams with the same flags, in one system call (sendmmsg), returns the number of datagrams sent */
+	int			 sendDatagrams(Exception& ex, uint32_t count);
 
 	template<typename Type>
 	bool getOption(Exception& ex, int level, int option, Type& value) const {
@@ -252,6 +300,10 @@ private:
 	OnDisconnection				_onDisconnection;
 
 	uint16_t						_threadReceive;
+	uint16_t						_reactor;
+	Shared<RingBuffer>			_pRecvRing;
+	uint16_t						_recvBatch;
+	uint32_t						_recvBatchSize;
 	std::atomic<uint32_t>			_receiving;
 	std::atomic<uint8_t>			_reading;
 	std::atomic<bool>			_sending;
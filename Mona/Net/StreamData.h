@@ -17,7 +17,7 @@ details (or else see http://mozilla.org/MPL/2.0/).
 #pragma once
 
 #include "Mona/Mona.h"
-#include "Mona/Memory/Packet.h"
+#include "Mona/Memory/Slice.h"
 
 namespace Mona {
 
@@ -27,11 +27,11 @@ struct StreamData : virtual Object {
 	bool addStreamData(const Packet& packet, uint32_t limit, Args... args) {
 		// Call onStreamData just one time to prefer recursivity rather "while repeat", and allow a "flush" info!
 		uint32_t rest;
-		Shared<Buffer> pBuffer(std::move(_pBuffer)); // because onStreamData returning 0 can delete this!
-		if (pBuffer) {
-			pBuffer->append(packet.data(), packet.size());
-			Packet buffer(static_pointer_cast<const Bytes>(pBuffer)); // trick to keep reference to _pBuffer!
-			rest = min(onStreamData(buffer, std::forward<Args>(args)...), pBuffer->size());
+		Slice slice(std::move(_slice)); // because onStreamData returning 0 can delete this!
+		if (slice) {
+			slice.append(packet.data(), packet.size()); // in place, or copy if a packet still references the end of buffer (copy-on-write)
+			Packet buffer(slice.packet());
+			rest = min(onStreamData(buffer, std::forward<Args>(args)...), slice.size());
 		} else {
 			Packet buffer(packet);
 			rest = min(onStreamData(buffer, std::forward<Args>(args)...), packet.size());
@@ -40,28 +40,21 @@ struct StreamData : virtual Object {
 			return true;
 		if (rest > limit) // test limit on rest no before to allow a pBuffer in input of limit size + pBuffer stored = limit size too
 			return false;
-		_pBuffer = std::move(pBuffer);
-		if (!_pBuffer) { // copy!
-			_pBuffer.set(packet.data() + packet.size() - rest, rest);
+		if (!slice) { // copy!
+			_slice.append(packet.data() + packet.size() - rest, rest);
 			return true;
 		}
-		if (!_pBuffer.unique()) { // if not unique => packet hold by user in "parse", buffer immutable now
-			_pBuffer.set(_pBuffer->data() + _pBuffer->size() - rest, rest);
-			return true;
-		}
-		if (rest < _pBuffer->size()) {
-			memmove(_pBuffer->data(), _pBuffer->data() + _pBuffer->size() - rest, rest);
-			_pBuffer->resize(rest, true);
-		}
+		// consumed bytes are just skipped, no memmove
+		_slice = std::move(slice += slice.size() - rest);
 		return true;
 	}
-	void clearStreamData() { _pBuffer.reset(); }
-	Shared<Buffer>& clearStreamData(Shared<Buffer>& pBuffer) { return pBuffer = std::move(_pBuffer); }
+	void clearStreamData() { _slice.reset(); }
+	Shared<Buffer>& clearStreamData(Shared<Buffer>& pBuffer) { return _slice.release(pBuffer); }
 
 private:
 	virtual uint32_t onStreamData(Packet& buffer, Args... args) = 0;
 
-	Shared<Buffer> _pBuffer;
+	Slice _slice;
 };
 
 } // namespace Mona
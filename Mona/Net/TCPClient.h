@@ -51,6 +51,9 @@ struct TCPClient : private StreamData<>, virtual Object {
 
 	virtual bool	send(Exception& ex, const Packet& packet, int flags = 0);
 
+	/*!
+	Queue pRunner on the sending thread, the same runner can be sent again before it runs (runs once by sending),
+	it's then queued through a small allocated wrapper */
 	template<typename RunnerType>
 	void		send(const Shared<RunnerType>& pRunner) { io.threadPool.queue(_sendingTrack, pRunner); }
 	template <typename RunnerType, typename ...Args>
@@ -34,14 +34,40 @@ const Shared<Socket>& TCPServer::socket() {
 }
 
 bool TCPServer::start(Exception& ex,const SocketAddress& address) {
+	uint16_t reactors(io.reactors());
+	SocketAddress bindAddress(address);
+	if (reactors > 1) {
+		// one listening socket by reactor, the system shards connections between them.
+		// SO_REUSEPORT would allow an other listener to bind the same address without error, so a first bind without it
+		// checks that the address is free (and resolves a port 0) before to open the listening sockets with SO_REUSEPORT
+		Socket probe(Socket::TYPE_STREAM);
+		if (!probe.bind(ex, address))
+			return false;
+		bindAddress = probe.address();
+		socket()->setReusePort(true);
+	} // probe closed here, address free for the listening sockets
 	// listen has to be called BEFORE io.sibscribe (can subscribe after bind + listen for server, no risk to miss an event)
-	if (socket()->bind(ex, address) && _pSocket->listen(ex) && (_subscribed=io.subscribe(ex, _pSocket, onConnection, onError)))
-		return true;
-	stop();
-	return false;
+	if (!socket()->bind(ex, bindAddress) || !_pSocket->listen(ex) || !(_subscribed=io.subscribe(ex, _pSocket, onConnection, onError))) {
+		stop();
+		return false;
+	}
+	while (uint16_t(_sockets.size() + 1) < reactors) {
+		Shared<Socket> pSocket(newSocket());
+		pSocket->setReusePort(true);
+		if (!pSocket->bind(ex, _pSocket->address()) || !pSocket->listen(ex) || !io.subscribe(ex, pSocket, onConnection, onError)) {
+			// SO_REUSEPORT unsupported? keep the listening sockets already opened, ex as warning
+			WARN("TCPServer ", _pSocket->address(), " listens with ", _sockets.size() + 1, " sockets rather than ", reactors, ", ", ex);
+			break;
+		}
+		_sockets.emplace_back(move(pSocket));
+	}
+	return true;
 }
 
 void TCPServer::stop() {
+	for (Shared<Socket>& pSocket : _sockets)
+		io.unsubscribe(pSocket);
+	_sockets.clear();
 	if (_subscribed) {
 		_subscribed = false;
 		io.unsubscribe(_pSocket);
@@ -38,6 +38,10 @@ struct TCPServer : virtual Object {
 	Socket*				  operator->() { return socket().get(); }
 
 
+	/*!
+	Listen on address, with several reactors (see IOSocket::setReactors) a listening socket by reactor is opened with SO_REUSEPORT,
+	socket() is the first one. Fails if address is already used, even by listening sockets with SO_REUSEPORT,
+	returns true with ex as warning if some of the other listening sockets can't be opened */
 	bool		start(Exception& ex, const SocketAddress& address);
 	bool		start(Exception& ex, const IPAddress& ip=IPAddress::Wildcard()) { return start(ex, SocketAddress(ip, 0)); }
 	bool		running() const { return _pSocket && _pSocket->listening();  }
@@ -47,6 +51,7 @@ protected:
 
 private:
 	Shared<Socket>		_pSocket;
+	std::vector<Shared<Socket>>	_sockets; // other listening sockets, one by reactor
 	Shared<TLS>			_pTLS;
 	bool				_subscribed;
 };
@@ -48,6 +48,7 @@ struct TLS : virtual Object {
 		bool connect(Exception& ex, const SocketAddress& address, uint16_t timeout = 0) override;
 		int	 receive(Exception& ex, char* buffer, uint32_t size, int flags = 0) { return Mona::Socket::receive(ex, buffer, size, flags); }
 		int	 sendTo(Exception& ex, const char* data, uint32_t size, const SocketAddress& address, int flags = 0);
+		int	 sendTo(Exception& ex, const PacketList& packets, const SocketAddress& address, int flags = 0) override { return pTLS ? sendJoined(ex, packets, address, flags) : Mona::Socket::sendTo(ex, packets, address, flags); }
 		bool flush(Exception& ex) { return Mona::Socket::flush(ex); }
 
 	private:
@@ -49,6 +49,9 @@ struct UDPSocket : virtual Object {
 	bool		send(Exception& ex, const Packet& packet, int flags = 0) { return send(ex, packet, SocketAddress::Wildcard(), flags); }
 	bool		send(Exception& ex, const Packet& packet, const SocketAddress& address, int flags = 0) { return socket()->write(ex, packet, address, flags) != -1; }
 
+	/*!
+	Queue pRunner on the sending thread, the same runner can be sent again before it runs (runs once by sending),
+	it's then queued through a small allocated wrapper */
 	template<typename RunnerType>
 	void		send(const Shared<RunnerType>& pRunner) { io.threadPool.queue(_sendingTrack, pRunner); }
 	template <typename RunnerType, typename ...Args>
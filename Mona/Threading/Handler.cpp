@@ -23,26 +23,45 @@ using namespace std;
 namespace Mona {
 
 void Handler::reset(Signal& signal) {
-	std::lock_guard<std::mutex> lock(_mutex);
-	_runners.clear();
+	RunnerQueue::Batch runners(_runners); // clear
+	_backlog -= runners.count();
 	_pSignal = &signal;
+	_runners.open();
 }
 
 uint32_t Handler::flush(bool last) {
 	// Flush all what is possible now, and not dynamically in real-time (in rechecking _runners)
 	// to keep the possibility to do something else between two flushs!
-	deque<Shared<Runner>> runners;
-	{
-		lock_guard<mutex> lock(_mutex);
-		if(last)
-			_pSignal = NULL;
-		runners = move(_runners);
+	uint32_t count(0);
+	do {
+		RunnerQueue::Batch runners(_runners);
+		count += runners.count();
+		while (Shared<Runner> pRunner = runners.pop()) {
+			pRunner->run('.', pRunner->name); // '.' to signal that its a sub-runner, wait the name of the thread in htop
+			--_backlog;
+		}
+	} while (last && !_runners.close()); // last => flush until to close the queue
+	if (last) {
+		// wait the end of producers which could set the signal
+		while (_producers)
+			this_thread::yield();
 	}
-	for (Shared<Runner>& pRunner : runners) {
-		pRunner->run('.', pRunner->name); // '.' to signal that its a sub-runner, wait the name of the thread in htop
-		pRunner.reset(); // release resources
-	}
-	return runners.size();
+	return count;
+}
+
+bool Handler::tryQueue(vector<Shared<Runner>>& runners) const {
+	if (Scheduler::TryQueue(self, runners))
+		return true;
+	uint32_t count(uint32_t(runners.size()));
+	++_producers; // signal can't be released before the end of this call (see flush(true))
+	_backlog += count; // before push, else flush could decrement it before
+	RunnerQueue::State state(_runners.push(runners, false));
+	if (state == RunnerQueue::STATE_EMPTY)
+		_pSignal->set(); // wake up only if queue was empty
+	else if (state == RunnerQueue::STATE_CLOSED)
+		_backlog -= count;
+	--_producers;
+	return state != RunnerQueue::STATE_CLOSED;
 }
 
 bool Handler::tryQueue(const Event<void()>& onResult) const {
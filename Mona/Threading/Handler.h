@@ -17,36 +17,57 @@ details (or else see http://mozilla.org/MPL/2.0/).
 #pragma once
 
 #include "Mona/Mona.h"
-#include "Mona/Threading/Runner.h"
+#include "Mona/Threading/RunnerQueue.h"
 #include "Mona/Util/Event.h"
 #include "Mona/Threading/Signal.h"
-#include <deque>
+#include "Mona/Threading/Scheduler.h"
 
 namespace Mona {
 
 struct Handler : virtual Object {
-	Handler(Signal& signal) : _pSignal(&signal) {}
-	Handler() : _pSignal(NULL) {}
+	Handler(Signal& signal) : _pSignal(&signal), _producers(0), _backlog(0), _highWater(0) {}
+	Handler() : _pSignal(NULL), _runners(true), _producers(0), _backlog(0), _highWater(0) {}
 
 	void	 reset(Signal& signal);
 	uint32_t	 flush(bool last=false);
 
+	/*!
+	Runners queued and not yet run */
+	uint32_t	backlog() const { return _backlog; }
+	/*!
+	High-water mark of backlog, 0 by default (unbounded). Queueing is never refused (control actions must pass),
+	but producers have to check saturated() to stop to produce (see IOSocket which stops to rearm reception) */
+	uint32_t	highWater() const { return _highWater; }
+	Handler&	setHighWater(uint32_t count) { _highWater = count; return self; }
+	/*!
+	True if backlog has reached high-water mark */
+	bool		saturated() const { uint32_t highWater(_highWater); return highWater && _backlog >= highWater; }
+
 	/*!
 	Try to queue a shared RunnerType, returns false if failed */
 	template<typename RunnerType, typename = typename std::enable_if<std::is_constructible<Shared<Runner>, RunnerType>::value>::type>
 	bool tryQueue(RunnerType&& pRunner) const {
 		DEBUG_ASSERT(pRunner); // more easy to debug that if it fails in the thread!
-		std::lock_guard<std::mutex> lock(_mutex);
-		if (!_pSignal)
-			return false;
-		_runners.emplace_back(std::forward<RunnerType>(pRunner));
-		_pSignal->set();
-		return true;
+		if (Scheduler::TryQueue(self, std::forward<RunnerType>(pRunner)))
+			return true;
+		++_producers; // signal can't be released before the end of this call (see flush(true))
+		++_backlog; // before push, else flush could decrement it before
+		RunnerQueue::State state(_runners.push(std::forward<RunnerType>(pRunner), false));
+		if (state == RunnerQueue::STATE_EMPTY)
+			_pSignal->set(); // wake up only if queue was empty
+		else if (state == RunnerQueue::STATE_CLOSED)
+			--_backlog;
+		--_producers;
+		return state != RunnerQueue::STATE_CLOSED;
 	}
 	/*!
+	Try to queue runners at once (one CAS and one wake up at most), returns false if failed.
+	runners is cleared if queued */
+	bool tryQueue(std::vector<Shared<Runner>>& runners) const;
+	/*!
 	Try to build and queue a RunnerType, returns false if failed */
 	template <typename RunnerType, typename ...Args>
-	bool tryQueue(Args&&... args) const { return tryQueue(std::make_shared<RunnerType>(std::forward<Args>(args)...)); }
+	bool tryQueue(Args&&... args) const { return tryQueue(Runner::Make<RunnerType>(std::forward<Args>(args)...)); }
 	/*!
 	Try to queue an event with arguments call, returns false if failed */
 	template<typename ResultType, typename ...Args>
@@ -58,7 +79,7 @@ struct Handler : virtual Object {
 			Event<void(ResultType)>								_onResult;
 			typename std::remove_reference<ResultType>::type	_result;
 		};
-		return tryQueue(std::make_shared<Result>(onResult, std::forward<Args>(args)...));
+		return tryQueue(Runner::Make<Result>(onResult, std::forward<Args>(args)...));
 	}
 	/*!
 	Try to queue an event without argument, returns false if failed */
@@ -71,10 +92,16 @@ struct Handler : virtual Object {
 			FATAL_ERROR("Impossible to queue ", typeOf<RunnerType>());
 	}
 	/*!
+	Queue runners at once (one CAS and one wake up at most), runners is cleared */
+	void queue(std::vector<Shared<Runner>>& runners) const {
+		if (!tryQueue(runners))
+			FATAL_ERROR("Impossible to queue ", runners.size(), " runners");
+	}
+	/*!
 	Build and queue a RunnerType, returns false if failed */
 	template <typename RunnerType, typename ...Args>
 	void queue(Args&&... args) const {
-		if(!tryQueue(std::make_shared<RunnerType>(std::forward<Args>(args)...)))
+		if(!tryQueue(Runner::Make<RunnerType>(std::forward<Args>(args)...)))
 			FATAL_ERROR("Impossible to queue ", typeOf<RunnerType>());
 	}
 	/*!
@@ -93,9 +120,13 @@ struct Handler : virtual Object {
 
 private:
 
-	mutable std::mutex					_mutex;
-	mutable std::deque<Shared<Runner>>	_runners;
+	mutable RunnerQueue					_runners; // closed when no signal
+	mutable std::atomic<uint32_t>		_producers;
+	mutable std::atomic<uint32_t>		_backlog;
+	std::atomic<uint32_t>				_highWater;
 	Signal*								_pSignal;
+
+	friend struct Scheduler;
 };
 
 
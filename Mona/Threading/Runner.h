@@ -19,29 +19,65 @@ details (or else see http://mozilla.org/MPL/2.0/).
 #include "Mona/Mona.h"
 #include "Mona/Threading/Thread.h"
 #include "Mona/Logs/Logs.h"
+#include "Mona/Memory/Slab.h"
+#include "Mona/Threading/RunnerStats.h"
 
 namespace Mona {
 
 
 struct Runner : virtual Object {
-	Runner(const char* name) : name(name), noLog(Logs::Logging()), noDump(Logs::Dumping())  {}
+	/*!
+	Lane of the runner in its ThreadQueue, LANE_HIGH runners pass before LANE_NORMAL runners,
+	with a weighted draining to not starve LANE_NORMAL runners (see ThreadQueue::setLaneWeight) */
+	enum Lane : uint8_t {
+		LANE_HIGH = 0, // small control actions (accept, disconnection, flush...)
+		LANE_NORMAL, // bulk traffic
+		LANES
+	};
+
+	Runner(const char* name, Lane lane = LANE_NORMAL) : name(name), lane(lane), noLog(Logs::Logging()), noDump(Logs::Dumping()), _queueTime(0), _pNext(NULL), _hooked(false)  {}
 
 	const char* name;
+	Lane lane; // can be changed before queueing
 	bool noLog;
 	bool noDump;
 
+	/*!
+	Build a shared RunnerType in a recycled memory block (see Slab), runner and its control block are allocated at once */
+	template <typename RunnerType, typename ...Args>
+	static Shared<RunnerType> Make(Args&&... args) { return std::allocate_shared<RunnerType>(SlabAllocator<RunnerType>(), std::forward<Args>(args)...); }
+
 	template <typename ...Args>
 	void run(Args&&... args) {
-		Thread::ChangeName newName(std::forward<Args>(args)...);
-		Exception ex;
-		Logs::Disable logs(!noLog, !noDump);
-		AUTO_ERROR(run(ex), newName);
+		uint64_t start(RunnerStats::Enabled() ? RunnerStats::Now() : 0);
+		{
+			Thread::ChangeName newName(std::forward<Args>(args)...);
+			Exception ex;
+			Logs::Disable logs(!noLog, !noDump);
+			AUTO_ERROR(run(ex), newName);
+		}
+		if (start) // out of Logs::Disable scope to allow the periodic dump
+			RunnerStats::Record(name, _queueTime, start);
 	}
 
 private:
 	// If ex is raised, an error is displayed if the operation has returned false
 	// otherwise a warning is displayed
 	virtual bool run(Exception& ex) = 0;
+
+	/*!
+	Set queueing time if RunnerStats is enabled */
+	void queued() { _queueTime = RunnerStats::Enabled() ? RunnerStats::Now() : 0; }
+
+	uint64_t		_queueTime;
+	// RunnerQueue hook
+	Shared<Runner>	_pQueued; // reference held while queued
+	Runner*			_pNext;
+	std::atomic<bool>	_hooked; // taken by the RunnerQueue which holds _pQueued and _pNext
+
+	friend struct RunnerQueue;
+	friend struct ThreadQueue;
+	friend struct Scheduler;
 };
 
 
@@ -0,0 +1,137 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#include "Mona/Threading/RunnerQueue.h"
+
+using namespace std;
+
+
+namespace Mona {
+
+/*!
+Runner queued again before to run, as a queue of Shared<Runner> it will run one more time */
+struct RunnerQueue::Requeued : Runner, virtual Object {
+	Requeued(Shared<Runner>&& pRunner) : Runner(pRunner->name, pRunner->lane), _pRunner(move(pRunner)) {
+		noLog = _pRunner->noLog;
+		noDump = _pRunner->noDump;
+	}
+private:
+	bool run(Exception& ex) { return _pRunner->run(ex); }
+
+	Shared<Runner> _pRunner;
+};
+
+Runner* RunnerQueue::Hook(Shared<Runner>& pRunner) {
+	if (pRunner->_hooked.exchange(true, memory_order_acquire)) {
+		pRunner = Runner::Make<Requeued>(move(pRunner));
+		pRunner->_hooked = true;
+	}
+	Runner* pNew(pRunner.get());
+	pNew->_pQueued = move(pRunner);
+	pNew->queued();
+	return pNew;
+}
+
+Shared<Runner> RunnerQueue::Unhook(Runner& runner) {
+	Shared<Runner> pRunner(move(runner._pQueued));
+	runner._pNext = NULL;
+	runner._hooked.store(false, memory_order_release);
+	return pRunner;
+}
+
+RunnerQueue::State RunnerQueue::push(Shared<Runner> pRunner, bool reopen) {
+	Runner* pNew(Hook(pRunner));
+	Runner* pLast(_pLast.load(memory_order_relaxed));
+	do {
+		if (pLast == Closed() && !reopen) {
+			Unhook(*pNew);
+			return STATE_CLOSED;
+		}
+		pNew->_pNext = pLast == Closed() ? NULL : pLast;
+	} while (!_pLast.compare_exchange_weak(pLast, pNew, memory_order_release, memory_order_relaxed));
+	if (!pLast)
+		return STATE_EMPTY;
+	return pLast == Closed() ? STATE_CLOSED : STATE_FILLED;
+}
+
+RunnerQueue::State RunnerQueue::push(vector<Shared<Runner>>& runners, bool reopen) {
+	if (runners.empty())
+		return STATE_FILLED; // nothing to wake up
+	// chain runners in reverse order, the first one will be linked to the last runner of the queue
+	Runner* pFirst(NULL);
+	Runner* pNew(NULL);
+	for (Shared<Runner>& pRunner : runners) {
+		Runner* pPrevious(pNew);
+		pNew = Hook(pRunner);
+		pNew->_pNext = pPrevious;
+		if (!pFirst)
+			pFirst = pNew;
+	}
+	Runner* pLast(_pLast.load(memory_order_relaxed));
+	do {
+		if (pLast == Closed() && !reopen) {
+			// give back runners
+			size_t i(runners.size());
+			for (Runner* pRunner = pNew; i--;) {
+				Runner* pPrevious(pRunner->_pNext);
+				runners[i] = Unhook(*pRunner);
+				pRunner = pPrevious;
+			}
+			return STATE_CLOSED;
+		}
+		pFirst->_pNext = pLast == Closed() ? NULL : pLast;
+	} while (!_pLast.compare_exchange_weak(pLast, pNew, memory_order_release, memory_order_relaxed));
+	runners.clear();
+	if (!pLast)
+		return STATE_EMPTY;
+	return pLast == Closed() ? STATE_CLOSED : STATE_FILLED;
+}
+
+bool RunnerQueue::close() {
+	Runner* pLast(NULL);
+	return _pLast.compare_exchange_strong(pLast, Closed(), memory_order_acq_rel) || pLast == Closed();
+}
+
+void RunnerQueue::open() {
+	Runner* pLast(Closed());
+	_pLast.compare_exchange_strong(pLast, NULL, memory_order_acq_rel);
+}
+
+RunnerQueue::Batch::Batch(RunnerQueue& queue) : _pFirst(NULL), _count(0) {
+	Runner* pRunner(queue._pLast.load(memory_order_acquire));
+	if (!pRunner || pRunner == Closed())
+		return; // empty (only the consumer can empty or close the queue)
+	pRunner = queue._pLast.exchange(NULL, memory_order_acquire);
+	// reverse the chain to get queueing order
+	while (pRunner) {
+		Runner* pNext(pRunner->_pNext);
+		pRunner->_pNext = _pFirst;
+		_pFirst = pRunner;
+		pRunner = pNext;
+		++_count;
+	}
+}
+
+Shared<Runner> RunnerQueue::Batch::pop() {
+	if (!_pFirst)
+		return nullptr;
+	Runner* pRunner(_pFirst);
+	_pFirst = pRunner->_pNext;
+	return Unhook(*pRunner);
+}
+
+
+} // namespace Mona
@@ -0,0 +1,79 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#pragma once
+
+#include "Mona/Mona.h"
+#include "Mona/Threading/Runner.h"
+#include <vector>
+
+namespace Mona {
+
+/*!
+Lock-free multi-producer single-consumer queue of runners, intrusive (no allocation),
+a runner queued again before to run (in this queue or an other one) is queued through a small wrapper holding it.
+Producers push by CAS, the consumer takes all runners at once (see Batch), and can close the queue when empty to stop consuming */
+struct RunnerQueue : virtual Object {
+	RunnerQueue(bool closed = false) : _pLast(closed ? Closed() : NULL) {}
+	~RunnerQueue() { Batch runners(self); }
+
+	enum State {
+		STATE_FILLED = 0,
+		STATE_EMPTY, // consumer has to be woken up
+		STATE_CLOSED
+	};
+
+	/*!
+	Push a runner, returns the previous state of the queue, on STATE_CLOSED pRunner is pushed only if reopen is true. Thread-safe */
+	State	push(Shared<Runner> pRunner, bool reopen = true);
+	/*!
+	Push runners at once (one CAS) in their order, runners is cleared if pushed. Thread-safe */
+	State	push(std::vector<Shared<Runner>>& runners, bool reopen = true);
+	/*!
+	Close the queue if empty, returns false if not empty. Consumer only */
+	bool	close();
+	/*!
+	Reopen a closed queue. Consumer only */
+	void	open();
+	bool	empty() const { Runner* pLast(_pLast.load(std::memory_order_acquire)); return !pLast || pLast == Closed(); }
+
+	/*!
+	Runners queued taken all at once, in their queueing order. Consumer only */
+	struct Batch : virtual Object {
+		Batch(RunnerQueue& queue);
+		~Batch() { while (pop()); }
+
+		uint32_t		count() const { return _count; }
+		Shared<Runner>	pop();
+	private:
+		Runner*		_pFirst;
+		uint32_t	_count;
+	};
+
+private:
+	static Runner* Closed() { return (Runner*)1; }
+	/*!
+	Take the hook of pRunner (or of a wrapper if it's already queued) and give it the reference */
+	static Runner* Hook(Shared<Runner>& pRunner);
+	static Shared<Runner> Unhook(Runner& runner);
+
+	struct Requeued;
+
+	std::atomic<Runner*>	_pLast; // last runner pushed, chained to previous ones in reverse order
+};
+
+
+} // namespace Mona
@@ -0,0 +1,198 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#include "Mona/Threading/RunnerStats.h"
+#if defined(_MSC_VER)
+	#include <intrin.h>
+#endif
+
+using namespace std;
+
+
+namespace Mona {
+
+atomic<bool>		RunnerStats::_Enabled(false);
+atomic<uint32_t>	RunnerStats::_LogInterval(0);
+atomic<uint64_t>	RunnerStats::_NextLog(0);
+
+static uint8_t LastBit(uint64_t value) {
+#if defined(_MSC_VER)
+	unsigned long index;
+	_BitScanReverse64(&index, value);
+	return uint8_t(index);
+#else
+	return uint8_t(63 - __builtin_clzll(value));
+#endif
+}
+
+/*!
+Lock-free histogram, written by any thread */
+struct Recorder : virtual Object {
+	Recorder() : _count(0), _sum(0), _max(0) { for (atomic<uint64_t>& bucket : _buckets) bucket = 0; }
+
+	void record(uint64_t value) {
+		_buckets[RunnerStats::BucketOf(value)].fetch_add(1, memory_order_relaxed);
+		_count.fetch_add(1, memory_order_relaxed);
+		_sum.fetch_add(value, memory_order_relaxed);
+		uint64_t max(_max.load(memory_order_relaxed));
+		while (value > max && !_max.compare_exchange_weak(max, value, memory_order_relaxed));
+	}
+	void snapshot(RunnerStats::Histogram& histogram) const {
+		histogram.count = 0;
+		for (uint16_t i = 0; i < RunnerStats::BUCKETS; ++i)
+			histogram.count += histogram.buckets[i] = _buckets[i].load(memory_order_relaxed); // count consistent with buckets
+		histogram.sum = _sum.load(memory_order_relaxed);
+		histogram.max = _max.load(memory_order_relaxed);
+	}
+	void reset() {
+		for (atomic<uint64_t>& bucket : _buckets)
+			bucket.store(0, memory_order_relaxed);
+		_count = _sum = _max = 0;
+	}
+private:
+	atomic<uint64_t>	_buckets[RunnerStats::BUCKETS];
+	atomic<uint64_t>	_count;
+	atomic<uint64_t>	_sum;
+	atomic<uint64_t>	_max;
+};
+
+struct RunnerStats::Entry : virtual Object {
+	Entry(const char* name) : pName(name), name(name) {}
+	const char*			pName; // first pointer seen, fast path of Find
+	const std::string	name;
+	Recorder			wait;
+	Recorder			run;
+};
+
+// Never deleted, a runner can be recording while static objects are destroyed
+atomic<RunnerStats::Entry*>* RunnerStats::_Entries(new atomic<RunnerStats::Entry*>[ENTRIES]());
+
+
+uint64_t RunnerStats::Histogram::percentile(double percentile) const {
+	if (!count)
+		return 0;
+	uint64_t rank(uint64_t(ceil(count * percentile / 100)));
+	if (!rank)
+		rank = 1;
+	for (uint16_t i = 0; i < BUCKETS; ++i) {
+		if (buckets[i] < rank) {
+			rank -= buckets[i];
+			continue;
+		}
+		// middle of the bucket, but never more than max
+		uint64_t value(ValueOf(i) + ((i + 1 < BUCKETS ? ValueOf(i + 1) : ValueOf(i)) - ValueOf(i)) / 2);
+		return value < max ? value : max;
+	}
+	return max;
+}
+
+uint16_t RunnerStats::BucketOf(uint64_t value) {
+	if (value < (2 << SUB_BITS))
+		return uint16_t(value);
+	uint8_t exponent(LastBit(value));
+	if (exponent > 40)
+		return BUCKETS - 1;
+	return uint16_t(((exponent - SUB_BITS + 1) << SUB_BITS) + (value >> (exponent - SUB_BITS)) - (1 << SUB_BITS));
+}
+
+RunnerStats::Entry* RunnerStats::Find(const char* name) {
+	// FNV-1a hash
+	uint32_t hash(2166136261);
+	for (const char* current = name; *current; ++current)
+		hash = (hash ^ uint8_t(*current)) * 16777619;
+	for (uint32_t i = 0; i < ENTRIES; ++i) {
+		atomic<Entry*>& slot(_Entries[(hash + i) & (ENTRIES - 1)]);
+		Entry* pEntry(slot.load(memory_order_acquire));
+		if (!pEntry) {
+			Entry* pNew(new Entry(name));
+			if (slot.compare_exchange_strong(pEntry, pNew, memory_order_acq_rel))
+				return pNew;
+			delete pNew; // inserted meanwhile
+		}
+		if (pEntry->pName == name || pEntry->name == name)
+			return pEntry;
+	}
+	return NULL; // full
+}
+
+void RunnerStats::Record(const char* name, uint64_t queued, uint64_t start) {
+	uint64_t end(Now());
+	Entry* pEntry(Find(name));
+	if (pEntry) {
+		if (queued && queued <= start)
+			pEntry->wait.record(start - queued);
+		pEntry->run.record(end - start);
+	}
+	// periodic dump
+	uint32_t interval(_LogInterval.load(memory_order_relaxed));
+	if (!interval)
+		return;
+	uint64_t next(_NextLog.load(memory_order_relaxed));
+	if (end < next)
+		return;
+	if (!_NextLog.compare_exchange_strong(next, end + uint64_t(interval) * 1000000, memory_order_relaxed) || !next)
+		return; // an other thread dumps, or first time (starts the interval)
+	Log();
+}
+
+vector<RunnerStats::Stats>& RunnerStats::Snapshot(vector<Stats>& stats) {
+	stats.clear();
+	for (uint32_t i = 0; i < ENTRIES; ++i) {
+		Entry* pEntry(_Entries[i].load(memory_order_acquire));
+		if (!pEntry)
+			continue;
+		stats.emplace_back();
+		stats.back().name = pEntry->name;
+		pEntry->wait.snapshot(stats.back().wait);
+		pEntry->run.snapshot(stats.back().run);
+	}
+	return stats;
+}
+
+void RunnerStats::Reset() {
+	for (uint32_t i = 0; i < ENTRIES; ++i) {
+		Entry* pEntry(_Entries[i].load(memory_order_acquire));
+		if (!pEntry)
+			continue;
+		pEntry->wait.reset();
+		pEntry->run.reset();
+	}
+}
+
+static string& Duration(string& buffer, uint64_t nanoseconds) {
+	if (nanoseconds < 1000)
+		return String::Assign(buffer, nanoseconds, "ns");
+	if (nanoseconds < 1000000)
+		return String::Assign(buffer, String::Format<double>("%.1f", nanoseconds / 1000.0), "us");
+	return String::Assign(buffer, String::Format<double>("%.1f", nanoseconds / 1000000.0), "ms");
+}
+
+void RunnerStats::Log(LOG_LEVEL level) {
+	vector<Stats> stats;
+	string mean, p50, p99, max;
+	for (const Stats& stat : Snapshot(stats)) {
+		if (!stat.run.count)
+			continue;
+		if (stat.wait.count)
+			LOG(level, "Runner ", stat.name, " wait, ", stat.wait.count, " runs, mean ", Duration(mean, stat.wait.mean()), ", p50 ", Duration(p50, stat.wait.percentile(50)),
+				", p99 ", Duration(p99, stat.wait.percentile(99)), ", max ", Duration(max, stat.wait.max));
+		LOG(level, "Runner ", stat.name, " run, ", stat.run.count, " runs, mean ", Duration(mean, stat.run.mean()), ", p50 ", Duration(p50, stat.run.percentile(50)),
+			", p99 ", Duration(p99, stat.run.percentile(99)), ", max ", Duration(max, stat.run.max));
+	}
+}
+
+
+} // namespace Mona
@@ -0,0 +1,98 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#pragma once
+
+#include "Mona/Mona.h"
+#include "Mona/Logs/Logs.h"
+#include <chrono>
+#include <vector>
+
+namespace Mona {
+
+/*!
+Optional instrumentation of runners, disabled by default: when enabled, every Runner records by its name
+its queue-wait time (from queueing to start) and its run time in lock-free log-linear histograms (HDR-style, 12.5% precision).
+Allows to find which stage of a pipeline (IOSocket -> ThreadPool -> Handler) adds latency */
+struct RunnerStats : virtual Static {
+	enum {
+		SUB_BITS = 3, // 8 sub-buckets by power of two
+		BUCKETS = 312 // until 2^41ns (~36mn), greater values are counted in the last bucket
+	};
+
+	/*!
+	Histogram snapshot, values in nanoseconds */
+	struct Histogram {
+		Histogram() : count(0), sum(0), max(0), buckets(BUCKETS, 0) {}
+
+		uint64_t				count;
+		uint64_t				sum;
+		uint64_t				max;
+		std::vector<uint64_t>	buckets;
+
+		uint64_t	mean() const { return count ? sum / count : 0; }
+		/*!
+		Value under which percentile% of values are (percentile from 0 to 100) */
+		uint64_t	percentile(double percentile) const;
+	};
+	struct Stats {
+		std::string	name;
+		Histogram	wait; // from queueing to start
+		Histogram	run;
+	};
+
+	static bool		Enabled() { return _Enabled.load(std::memory_order_relaxed); }
+	static void		Enable(bool value = true) { _Enabled = value; }
+	/*!
+	Snapshot of statistics, one entry by runner name */
+	static std::vector<Stats>& Snapshot(std::vector<Stats>& stats);
+	/*!
+	Clear statistics */
+	static void		Reset();
+	/*!
+	Dump statistics in logs (count, mean, p50, p99 and max of wait and run times by runner name) */
+	static void		Log(LOG_LEVEL level = LOG_INFO);
+	/*!
+	Interval between two periodic dumps in logs in milliseconds, 0 by default (no dump).
+	The dump is done by the first runner which ends after interval, no thread is required */
+	static uint32_t	LogInterval() { return _LogInterval; }
+	static void		SetLogInterval(uint32_t milliseconds) { _LogInterval = milliseconds; }
+
+	/*!
+	Monotonic time in nanoseconds */
+	static uint64_t Now() { return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count(); }
+	/*!
+	Record a run of runner name started at start and ending now, queued is the queueing time (0 if unknown) */
+	static void		Record(const char* name, uint64_t queued, uint64_t start);
+
+	static uint16_t	BucketOf(uint64_t value);
+	/*!
+	Smallest value of bucket */
+	static uint64_t	ValueOf(uint16_t bucket) { return bucket < (2 << SUB_BITS) ? bucket : uint64_t((bucket & ((1 << SUB_BITS) - 1)) | (1 << SUB_BITS)) << ((bucket >> SUB_BITS) - 1); }
+
+private:
+	enum { ENTRIES = 256 }; // maximum runner names, power of two
+	struct Entry;
+	static Entry*	Find(const char* name);
+
+	static std::atomic<Entry*>*		_Entries;
+	static std::atomic<bool>		_Enabled;
+	static std::atomic<uint32_t>	_LogInterval;
+	static std::atomic<uint64_t>	_NextLog;
+};
+
+
+} // namespace Mona
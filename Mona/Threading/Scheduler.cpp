@@ -0,0 +1,139 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#include "Mona/Threading/Scheduler.h"
+#include "Mona/Threading/ThreadQueue.h"
+#include "Mona/Threading/Handler.h"
+#include "Mona/Util/Util.h"
+
+using namespace std;
+
+namespace Mona {
+
+atomic<Scheduler*> Scheduler::_PCurrent(nullptr);
+atomic<uint32_t>   Scheduler::_Producers(0);
+
+Scheduler::Scheduler(uint32_t seed) : _seed(seed ? seed : (Util::Random<uint32_t>() | 1)), _pending(0), _steps(0) {
+	_generator.seed(_seed);
+	_pPrevious = _PCurrent.exchange(this);
+}
+
+Scheduler::~Scheduler() {
+	Scheduler* pCurrent(this);
+	if (!_PCurrent.compare_exchange_strong(pCurrent, _pPrevious))
+		FATAL_ERROR("Scheduler destroyed before the one created after it");
+	// wait the end of producers which could queue to this scheduler (see TryQueue)
+	while (_Producers)
+		this_thread::yield();
+	clear();
+}
+
+void Scheduler::queue(ThreadQueue& thread, vector<Shared<Runner>>& runners) {
+	for (Shared<Runner>& pRunner : runners)
+		push(&thread, NULL, move(pRunner));
+	runners.clear();
+}
+
+void Scheduler::queue(const Handler& handler, vector<Shared<Runner>>& runners) {
+	for (Shared<Runner>& pRunner : runners)
+		push(NULL, &handler, move(pRunner));
+	runners.clear();
+}
+
+Scheduler::Queue& Scheduler::queue(ThreadQueue* pThread, const Handler* pHandler) {
+	for (Unique<Queue>& pQueue : _queues) {
+		if (pQueue->pThread == pThread && pQueue->pHandler == pHandler)
+			return *pQueue;
+	}
+	_queues.emplace_back(SET, pThread, pHandler);
+	return *_queues.back();
+}
+
+void Scheduler::push(ThreadQueue* pThread, const Handler* pHandler, Shared<Runner>&& pRunner) {
+	DEBUG_ASSERT(pRunner);
+	// same metrics as a real queueing
+	if (pThread)
+		++pThread->_queueing;
+	else
+		++pHandler->_backlog;
+	pRunner->queued();
+	lock_guard<mutex> lock(_mutex);
+	Queue& queue(this->queue(pThread, pHandler));
+	queue.lanes[pRunner->lane < Runner::LANES ? pRunner->lane : Runner::LANE_NORMAL].emplace_back(move(pRunner));
+	++queue.count;
+	++_pending;
+}
+
+bool Scheduler::step() {
+	Shared<Runner> pRunner;
+	ThreadQueue* pThread;
+	const Handler* pHandler;
+	{
+		lock_guard<mutex> lock(_mutex);
+		if (!_pending)
+			return false;
+		// choose one of the queues holding runners
+		uint32_t index(uniform_int_distribution<uint32_t>(0, uint32_t(_queues.size()) - 1)(_generator));
+		while (!_queues[index]->count)
+			index = (index + 1) % _queues.size();
+		Queue& queue(*_queues[index]);
+		deque<Shared<Runner>>& lane(queue.lanes[queue.lanes[Runner::LANE_HIGH].empty() ? Runner::LANE_NORMAL : Runner::LANE_HIGH]);
+		pRunner = move(lane.front());
+		lane.pop_front();
+		--queue.count;
+		--_pending;
+		pThread = queue.pThread;
+		pHandler = queue.pHandler;
+	}
+	++_steps;
+	if (!pThread) {
+		pRunner->run('.', pRunner->name); // like Handler::flush
+		pRunner.reset();
+		--pHandler->_backlog;
+		return true;
+	}
+	ThreadQueue* pCurrent(ThreadQueue::_PCurrent);
+	ThreadQueue::_PCurrent = pThread; // runner can requeue on its thread (see ThreadQueue::Current)
+	pRunner->run(pRunner->name);
+	pRunner.reset(); // release before to decrement _queueing (track drained means runners released)
+	--pThread->_queueing;
+	ThreadQueue::_PCurrent = pCurrent;
+	return true;
+}
+
+uint32_t Scheduler::run(uint32_t count) {
+	uint32_t done(0);
+	while (done < count && step())
+		++done;
+	return done;
+}
+
+void Scheduler::clear() {
+	lock_guard<mutex> lock(_mutex);
+	for (Unique<Queue>& pQueue : _queues) {
+		for (deque<Shared<Runner>>& lane : pQueue->lanes) {
+			if (pQueue->pThread)
+				pQueue->pThread->_queueing -= uint32_t(lane.size());
+			else
+				pQueue->pHandler->_backlog -= uint32_t(lane.size());
+			lane.clear();
+		}
+		pQueue->count = 0;
+	}
+	_pending = 0;
+}
+
+} // namespace Mona
@@ -0,0 +1,105 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#pragma once
+
+#include "Mona/Mona.h"
+#include "Mona/Threading/Runner.h"
+#include <deque>
+#include <random>
+
+namespace Mona {
+
+struct ThreadQueue;
+struct Handler;
+/*!
+Deterministic execution mode, for tests, replay of ordering bugs and benchmarks without cross-thread hand-off:
+while a Scheduler exists, runners queued to a ThreadQueue (so to a ThreadPool) or to a Handler are not run by their threads
+but kept by the scheduler, and run on the thread calling step() or run(), one at a time.
+Every queue keeps its order (and its lanes, LANE_HIGH first), the queue of the next runner is chosen by a generator seeded with seed(),
+so the same seed with the same sequence of queueing replays the same interleaving.
+A Scheduler replaces the previous one until its destruction, so schedulers have to be destroyed in reverse order of their creation,
+queues have to outlive the runners it holds (see clear) */
+struct Scheduler : virtual Object {
+	/*!
+	seed 0 picks a random seed, to read with seed() to replay */
+	Scheduler(uint32_t seed = 0);
+	~Scheduler();
+
+	static Scheduler* Current() { return _PCurrent.load(std::memory_order_relaxed); }
+	/*!
+	Queue to the current scheduler if exists, else returns false without touching runner.
+	Can be called from any thread, the scheduler can't be destroyed during this call (see ~Scheduler) */
+	template<typename TargetType, typename RunnerType>
+	static bool TryQueue(TargetType& target, RunnerType&& runner) {
+		if (!_PCurrent.load(std::memory_order_relaxed))
+			return false; // no scheduler, without cost for a real queueing
+		++_Producers; // before to load the scheduler, destructor waits its end
+		Scheduler* pScheduler(_PCurrent.load());
+		if (pScheduler)
+			pScheduler->queue(target, std::forward<RunnerType>(runner));
+		--_Producers;
+		return pScheduler ? true : false;
+	}
+
+	uint32_t	seed() const { return _seed; }
+	/*!
+	Runners queued and not yet run */
+	uint32_t	pending() const { return _pending; }
+	/*!
+	Runners run since creation */
+	uint64_t	steps() const { return _steps; }
+
+	/*!
+	Run one runner, returns false if nothing is pending */
+	bool		step();
+	/*!
+	Run runners until nothing is pending or until count runners run, returns the number of runners run */
+	uint32_t	run(uint32_t count = 0xFFFFFFFF);
+	/*!
+	Release pending runners without running them */
+	void		clear();
+
+	void		queue(ThreadQueue& thread, Shared<Runner>&& pRunner) { push(&thread, NULL, std::move(pRunner)); }
+	void		queue(ThreadQueue& thread, std::vector<Shared<Runner>>& runners);
+	void		queue(const Handler& handler, Shared<Runner>&& pRunner) { push(NULL, &handler, std::move(pRunner)); }
+	void		queue(const Handler& handler, std::vector<Shared<Runner>>& runners);
+
+private:
+	struct Queue : virtual Object {
+		Queue(ThreadQueue* pThread, const Handler* pHandler) : pThread(pThread), pHandler(pHandler), count(0) {}
+		ThreadQueue*				pThread;
+		const Handler*				pHandler;
+		std::deque<Shared<Runner>>	lanes[Runner::LANES];
+		uint32_t					count;
+	};
+	void push(ThreadQueue* pThread, const Handler* pHandler, Shared<Runner>&& pRunner);
+	Queue& queue(ThreadQueue* pThread, const Handler* pHandler);
+
+	std::vector<Unique<Queue>>	_queues; // in order of first queueing, to not depend on addresses
+	std::mt19937				_generator;
+	std::mutex					_mutex; // protect _queues and _generator, queueing can come from an other thread
+	std::atomic<uint32_t>		_pending;
+	uint64_t					_steps;
+	const uint32_t				_seed;
+	Scheduler*					_pPrevious;
+
+	static std::atomic<Scheduler*> _PCurrent;
+	static std::atomic<uint32_t>   _Producers;
+};
+
+
+} // namespace Mona
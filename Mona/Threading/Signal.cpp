@@ -16,21 +16,70 @@ details (or else see http://mozilla.org/MPL/2.0/).
 
 #include "Mona/Threading/Signal.h"
 #include "Mona/Util/Exceptions.h"
+#include <thread>
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+	#include <immintrin.h>
+	#define PAUSE() _mm_pause()
+#elif defined(__aarch64__) || defined(__arm__)
+	#define PAUSE() __asm__ __volatile__("yield")
+#else
+	#define PAUSE() std::this_thread::yield()
+#endif
 
 
 namespace Mona {
 
 using namespace std;
 
+Signal::~Signal() {
+	// wait the end of set calls which could still access to members after having woken up the waiter
+	while (_setters)
+		this_thread::yield();
+}
+
+bool Signal::acquire() {
+	if (!_autoReset)
+		return _set;
+	bool set(true);
+	return _set.compare_exchange_strong(set, false);
+}
+
+bool Signal::spinWait() {
+	uint32_t spinning(_spinning.load(memory_order_relaxed));
+	if (!spinning)
+		return false;
+	for (uint32_t i = 0; i < spinning; ++i) {
+		if (_set.load(memory_order_relaxed) && acquire()) {
+			// success => increase the budget to the configured spin
+			uint32_t spin(_spin.load(memory_order_relaxed));
+			if (spinning < spin)
+				_spinning.store(min(spinning * 2, spin), memory_order_relaxed);
+			return true;
+		}
+		PAUSE();
+	}
+	// failure => halve the budget (keep 1 to be able to grow again)
+	_spinning.store(spinning > 1 ? spinning / 2 : 1, memory_order_relaxed);
+	return false;
+}
+
 bool Signal::wait(uint32_t millisec) {
+	if (acquire() || spinWait())
+		return true;
 	unique_lock<mutex> lock(_mutex);
+	++_waiters; // before to check _set, see set()
 #if !defined(_DEBUG)
 	try {
 #endif
 		if (millisec) {
 			auto timeout(chrono::system_clock::now() + chrono::milliseconds(millisec));
-			while (!_set && _condition.wait_until(lock, timeout) == cv_status::no_timeout);
-		} else while (!_set)
+			while (!acquire()) {
+				if (_condition.wait_until(lock, timeout) == cv_status::timeout) {
+					--_waiters;
+					return acquire();
+				}
+			}
+		} else while (!acquire())
 			_condition.wait(lock);
 
 #if !defined(_DEBUG)
@@ -40,22 +89,22 @@ bool Signal::wait(uint32_t millisec) {
 		FATAL_ERROR("Wait signal failed, unknown error");
 	}
 #endif
-	if (!_set)
-		return false;
-	if (_autoReset)
-		_set = false;
+	--_waiters;
 	return true;
 }
 
 void Signal::set() {
-	lock_guard<mutex> lock(_mutex);
+	++_setters; // signal can't be destroyed before the end of this call (see ~Signal)
 	_set = true;
-	_condition.notify_all();
+	if (_waiters) { // else nobody parked (a parking waiter increments _waiters before to check _set)
+		lock_guard<mutex> lock(_mutex);
+		_condition.notify_all();
+	}
+	--_setters;
 }
 
 
 void Signal::reset() {
-	lock_guard<mutex> lock(_mutex);
 	_set = false;
 }
 
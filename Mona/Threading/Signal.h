@@ -18,12 +18,21 @@ details (or else see http://mozilla.org/MPL/2.0/).
 
 #include "Mona/Mona.h"
 #include <condition_variable>
+#include <atomic>
 
 namespace Mona {
 
 
+/*!
+Signal to wake up a waiting thread.
+With a spin budget, wait spins (CPU pause) up to this number of cycles before to park the thread on its condition variable,
+it avoids the system calls when the signal is set shortly (hand-off between threads), the budget really spinned adapts itself
+to the successes of last waits. Useless on single-core machine, by default 0 (park immediatly).
+Whatever the mode, set calls the system only if a thread is parked.
+A waiter can return before the end of set, so destruction waits the end of set calls in progress (signal on the stack for a hand-off) */
 struct Signal : virtual Object {
-	Signal(bool autoReset=true) : _autoReset(autoReset), _set(false) {}
+	Signal(bool autoReset=true, uint32_t spin=0) : _autoReset(autoReset), _set(false), _waiters(0), _setters(0), _spin(spin), _spinning(spin) {}
+	~Signal();
 
 	void set();
 
@@ -31,10 +40,20 @@ struct Signal : virtual Object {
 	bool wait(uint32_t millisec = 0);
 
 	void reset();
+
+	uint32_t	spin() const { return _spin; }
+	Signal&		setSpin(uint32_t spin) { _spinning = _spin = spin; return self; }
 	
 private:
+	bool	acquire();
+	bool	spinWait();
+
 	bool					_autoReset;
-	bool					_set;
+	std::atomic<bool>		_set;
+	std::atomic<uint32_t>	_waiters; // parked threads
+	std::atomic<uint32_t>	_setters; // set calls in progress
+	std::atomic<uint32_t>	_spin;
+	std::atomic<uint32_t>	_spinning; // adaptive spin budget <= _spin
 	std::condition_variable _condition;
 	std::mutex				_mutex;
 };
@@ -0,0 +1,172 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#include "Mona/Threading/Task.h"
+#include "Mona/Memory/Slab.h"
+
+using namespace std;
+
+
+namespace Mona {
+
+struct Task::State : virtual Object {
+	struct Hop {
+		Hop(const ThreadPool* pThreadPool, uint16_t* pTrack, Step&& step) : pThreadPool(pThreadPool), pTrack(pTrack), step(move(step)) {}
+		Hop(Wait&& wait) : pThreadPool(NULL), pTrack(NULL), wait(move(wait)) {}
+		const ThreadPool*	pThreadPool; // NULL => handler thread
+		uint16_t*			pTrack; // NULL => untracked
+		Step				step;
+		Wait				wait;
+	};
+
+	State(const Handler& handler) : handler(handler), index(0), started(false), suspended(false) {}
+
+	const Handler&		handler;
+	vector<Hop>			hops;
+	OnError				onError;
+	size_t				index; // next hop, hops run one after the other (queueing orders memory)
+	atomic<bool>		started;
+	atomic<bool>		suspended; // on a wait hop
+};
+
+struct Task::Run : Runner, virtual Object {
+	Run(const Shared<State>& pState) : Runner("Task"), _pState(pState) {}
+private:
+	bool run(Exception&) {
+		size_t index(_pState->index++);
+		State::Hop& hop(_pState->hops[index]);
+		if (hop.wait) {
+			_pState->suspended = true;
+			hop.wait(Resume(_pState));
+			return true;
+		}
+		Exception ex;
+		if (!hop.step(ex) && !ex)
+			ex.set<Ex::Application::Error>("Task step ", index, " failed");
+		Next(_pState, ex);
+		return true;
+	}
+	Shared<State> _pState;
+};
+
+Task::Task(const Handler& handler) : _pState(allocate_shared<State>(SlabAllocator<State>(), handler)) {
+}
+
+Task& Task::add(const ThreadPool* pThreadPool, uint16_t* pTrack, Step&& step) {
+	if (_pState->started)
+		FATAL_ERROR("Task already started");
+	_pState->hops.emplace_back(pThreadPool, pTrack, move(step));
+	return self;
+}
+
+Task& Task::wait(Wait&& wait) {
+	if (_pState->started)
+		FATAL_ERROR("Task already started");
+	_pState->hops.emplace_back(move(wait));
+	return self;
+}
+
+Task& Task::onError(OnError&& onError) {
+	if (_pState->started)
+		FATAL_ERROR("Task already started");
+	_pState->onError = move(onError);
+	return self;
+}
+
+void Task::start() {
+	if (!_pState->started.exchange(true))
+		Next(_pState, nullptr);
+}
+
+void Task::Next(const Shared<State>& pState, const Exception& ex) {
+	if (ex) {
+		if (!pState->onError)
+			return;
+		struct Error : Runner, virtual Object {
+			Error(const Shared<State>& pState, const Exception& ex) : Runner("TaskError"), _pState(pState), _ex(ex) {}
+		private:
+			bool run(Exception&) { _pState->onError(_ex); return true; }
+			Shared<State>	_pState;
+			Exception		_ex;
+		};
+		pState->handler.tryQueue<Error>(pState, ex);
+		return;
+	}
+	if (pState->index >= pState->hops.size())
+		return; // end
+	const State::Hop& hop(pState->hops[pState->index]);
+	if (!hop.pThreadPool)
+		pState->handler.tryQueue<Run>(pState); // can fail only on handler closing
+	else if (hop.pTrack)
+		hop.pThreadPool->queue<Run>(*hop.pTrack, pState);
+	else
+		hop.pThreadPool->queue<Run>(nullptr, pState);
+}
+
+void Task::Resume::operator()(const Exception& ex) const {
+	if (_pState->suspended.exchange(false)) // one time
+		Next(_pState, ex);
+}
+
+// Size classes of continuation frames, recycled by Slab
+void* Task::AllocFrame(size_t size) {
+	if (size <= 128)
+		return Slab<128>::Alloc();
+	if (size <= 256)
+		return Slab<256>::Alloc();
+	if (size <= 512)
+		return Slab<512>::Alloc();
+	if (size <= 1024)
+		return Slab<1024>::Alloc();
+	if (size <= 2048)
+		return Slab<2048>::Alloc();
+	return ::operator new(size);
+}
+
+void Task::FreeFrame(void* frame, size_t size) {
+	if (size <= 128)
+		return Slab<128>::Free(frame);
+	if (size <= 256)
+		return Slab<256>::Free(frame);
+	if (size <= 512)
+		return Slab<512>::Free(frame);
+	if (size <= 1024)
+		return Slab<1024>::Free(frame);
+	if (size <= 2048)
+		return Slab<2048>::Free(frame);
+	::operator delete(frame);
+}
+
+#if defined(MONA_COROUTINES)
+void Task::Hop::await_suspend(coroutine_handle<> handle) const {
+	struct Resume : Runner, virtual Object {
+		Resume(coroutine_handle<> handle) : Runner("TaskHop"), _handle(handle) {}
+	private:
+		bool run(Exception&) { _handle.resume(); return true; }
+		coroutine_handle<> _handle;
+	};
+	if (_pHandler) {
+		if (!_pHandler->tryQueue<Resume>(handle))
+			handle.destroy(); // handler closing, coroutine will never continue
+	} else if (_pTrack)
+		_pThreadPool->queue<Resume>(*_pTrack, handle);
+	else
+		_pThreadPool->queue<Resume>(nullptr, handle);
+}
+#endif
+
+
+} // namespace Mona
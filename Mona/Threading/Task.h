@@ -0,0 +1,163 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#pragma once
+
+#include "Mona/Mona.h"
+#include "Mona/Threading/ThreadPool.h"
+#include "Mona/Threading/Handler.h"
+#include <vector>
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+	#define MONA_COROUTINES
+	#include <coroutine>
+#endif
+
+namespace Mona {
+
+/*!
+Asynchronous task written as a chain of steps rather than hand-rolled Runner subclasses with nested Handle structs.
+Each step runs on a ThreadPool track (or untracked with nullptr) or on the Handler thread, a hop from one step to the next
+costs one recycled Runner (see Runner::Make). A step returning false or raising ex stops the chain and onError is called on the Handler thread.
+A wait step suspends the chain until its Resume is called, from any thread (ex: in a File::OnReaden or Socket::OnReceived callback).
+Ex: Task(handler)
+		.then(threadPool, track, [](Exception& ex) { ... decode ... return true; })
+		.then([](Exception& ex) { ... on handler thread ... return true; })
+		.onError([](const Exception& ex) { ... })
+		.start();
+Tracks are given by reference and must stay alive until the end of the task (like Socket or File tracks).
+With C++20 (MONA_COROUTINES, see CMake option), Task::Coroutine allows to write the same thing with co_await */
+struct Task : virtual Object {
+	typedef std::function<bool(Exception& ex)>			Step;
+	typedef std::function<void(const Exception& ex)>	OnError;
+
+	struct Resume;
+	typedef std::function<void(const Resume& resume)>	Wait;
+
+	Task(const Handler& handler);
+
+	/*!
+	Step on a thread of threadPool, on track (or untracked with nullptr, see ThreadPool::queue) */
+	Task& then(const ThreadPool& threadPool, uint16_t& track, Step&& step) { return add(&threadPool, &track, std::move(step)); }
+	Task& then(const ThreadPool& threadPool, std::nullptr_t, Step&& step) { return add(&threadPool, NULL, std::move(step)); }
+	/*!
+	Step on the handler thread */
+	Task& then(Step&& step) { return add(NULL, NULL, std::move(step)); }
+	/*!
+	Step on the handler thread which suspends the chain until resume is called */
+	Task& wait(Wait&& wait);
+	Task& onError(OnError&& onError);
+	/*!
+	Start the chain, the task can't be changed or started again after */
+	void  start();
+
+private:
+	struct State;
+public:
+	/*!
+	Resume a suspended chain (see wait), thread-safe and callable one time, ex stops the chain */
+	struct Resume {
+		void operator()(const Exception& ex = nullptr) const;
+	private:
+		Resume(const Shared<State>& pState) : _pState(pState) {}
+		Shared<State> _pState;
+		friend struct Task;
+	};
+
+	/*!
+	Recycled memory for continuation frames (coroutines), by size classes until 2KB */
+	static void* AllocFrame(std::size_t size);
+	static void  FreeFrame(void* frame, std::size_t size);
+
+#if defined(MONA_COROUTINES)
+	/*!
+	Coroutine started immediatly, its frame is recycled (see AllocFrame), an unhandled exception is fatal.
+	Ex: Task::Coroutine Decode(const Handler& handler, const ThreadPool& threadPool, uint16_t& track) {
+			co_await Task::Hop(threadPool, track); // runs now on a thread of threadPool
+			... decode ...
+			co_await Task::Hop(handler); // back on handler thread
+		} */
+	struct Coroutine {
+		struct promise_type {
+			Coroutine			get_return_object() { return Coroutine(); }
+			std::suspend_never	initial_suspend() noexcept { return {}; }
+			std::suspend_never	final_suspend() noexcept { return {}; }
+			void				return_void() {}
+			void				unhandled_exception() { FATAL_ERROR("Unhandled exception in Task::Coroutine"); }
+
+			static void* operator new(std::size_t size) { return AllocFrame(size); }
+			static void  operator delete(void* frame, std::size_t size) { FreeFrame(frame, size); }
+		};
+	};
+	/*!
+	Awaitable to continue a coroutine on a thread of threadPool or on handler thread */
+	struct Hop {
+		Hop(const ThreadPool& threadPool, uint16_t& track) : _pThreadPool(&threadPool), _pTrack(&track), _pHandler(NULL) {}
+		Hop(const ThreadPool& threadPool, std::nullptr_t) : _pThreadPool(&threadPool), _pTrack(NULL), _pHandler(NULL) {}
+		Hop(const Handler& handler) : _pThreadPool(NULL), _pTrack(NULL), _pHandler(&handler) {}
+
+		bool await_ready() const noexcept { return false; }
+		void await_suspend(std::coroutine_handle<> handle) const;
+		void await_resume() const noexcept {}
+	private:
+		const ThreadPool*	_pThreadPool;
+		uint16_t*			_pTrack;
+		const Handler*		_pHandler;
+	};
+	/*!
+	Awaitable result given by a callback (ex: File::OnReaden, Socket::OnReceived), set can be called from any thread,
+	before or after co_await, the coroutine continues in the thread calling set (or immediatly if already set) */
+	template<typename ResultType>
+	struct Result {
+		Result() : _pState(SET) {}
+
+		void set(ResultType&& result) const {
+			_pState->result = std::move(result);
+			void* pHandle(_pState->pHandle.exchange(Done()));
+			if (pHandle)
+				std::coroutine_handle<>::from_address(pHandle).resume();
+		}
+		void set(const ResultType& result) const { set(ResultType(result)); }
+
+		bool		await_ready() const noexcept { return _pState->pHandle.load() == Done(); }
+		bool		await_suspend(std::coroutine_handle<> handle) const {
+			void* pHandle(NULL);
+			return _pState->pHandle.compare_exchange_strong(pHandle, handle.address()); // false => already set, continue
+		}
+		ResultType&	await_resume() const { return _pState->result; }
+	private:
+		static void* Done() { return (void*)1; }
+		struct State : virtual Object {
+			State() : pHandle(NULL) {}
+			std::atomic<void*>	pHandle;
+			ResultType			result;
+		};
+		Shared<State> _pState;
+	};
+#endif
+
+private:
+	struct Run;
+	/*!
+	Queue the next hop of the chain, or onError if ex */
+	static void Next(const Shared<State>& pState, const Exception& ex);
+
+	Task& add(const ThreadPool* pThreadPool, uint16_t* pTrack, Step&& step);
+
+	Shared<State> _pState;
+};
+
+
+} // namespace Mona
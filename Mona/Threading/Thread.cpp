@@ -25,6 +25,7 @@ details (or else see http://mozilla.org/MPL/2.0/).
 #include <pthread_np.h>
 #else
 #include <sys/prctl.h> // for thread name
+#include <pthread.h> // for affinity
 #endif
 #include <sys/syscall.h>
 #endif
@@ -36,6 +37,13 @@ using namespace std;
 
 namespace Mona {
 
+static string ToString(const Thread::Processors& processors) {
+	string result;
+	for (uint16_t processor : processors)
+		String::Append(result.empty() ? result : String::Append(result, ','), processor);
+	return result;
+}
+
 const uint32_t			Thread::MainId(Thread::CurrentId());
 thread_local string		Thread::_Name("Main");
 thread_local Thread*	Thread::_Me(NULL);
@@ -100,7 +108,7 @@ uint32_t Thread::CurrentId() {
 #endif
 }
 
-Thread::Thread() : _priority(PRIORITY_NORMAL), _stop(true) {
+Thread::Thread() : _priority(PRIORITY_NORMAL), _realTime(false), _placementRealTime(false), _stop(true) {
 }
 
 Thread::~Thread() {
@@ -124,28 +132,88 @@ void Thread::process() {
 	// set priority
 #if defined(_WIN32)
 		static int Priorities[] = { THREAD_PRIORITY_LOWEST, THREAD_PRIORITY_BELOW_NORMAL, THREAD_PRIORITY_NORMAL, THREAD_PRIORITY_ABOVE_NORMAL, THREAD_PRIORITY_HIGHEST };
-		if (_priority != PRIORITY_NORMAL && SetThreadPriority(GetCurrentThread(), Priorities[_priority]) == 0)
-			WARN("Impossible to change ", name(), " thread priority to ", Priorities[_priority]);
+		int priority(_realTime ? THREAD_PRIORITY_TIME_CRITICAL : Priorities[_priority]);
+		if ((_realTime || _priority != PRIORITY_NORMAL) && SetThreadPriority(GetCurrentThread(), priority) == 0)
+			WARN("Impossible to change ", name(), " thread priority to ", priority);
 #else
-		static int Min = sched_get_priority_min(SCHED_OTHER);
-		if(Min==-1) {
-			WARN("Impossible to compute minimum ", name(), " thread priority, ",strerror(errno));
+		if (_realTime) {
+			static int Min = sched_get_priority_min(SCHED_FIFO);
+			static int Max = sched_get_priority_max(SCHED_FIFO);
+			struct sched_param params;
+			params.sched_priority = Min + (Max - Min) * _priority / PRIORITY_HIGHEST;
+			int result;
+			if (Min == -1 || Max == -1) {
+				WARN("Impossible to compute real-time ", name(), " thread priority, ", strerror(errno));
+			} else if ((result = pthread_setschedparam(pthread_self(), SCHED_FIFO, &params)))
+				WARN("Impossible to set ", name(), " thread in real-time scheduling with priority ", params.sched_priority, ", ", strerror(result));
 		} else {
-			static int Max = sched_get_priority_max(SCHED_OTHER);
-			if(Max==-1) {
-				WARN("Impossible to compute maximum ", name(), " thread priority, ",strerror(errno));
+			static int Min = sched_get_priority_min(SCHED_OTHER);
+			if(Min==-1) {
+				WARN("Impossible to compute minimum ", name(), " thread priority, ",strerror(errno));
 			} else {
-				static int Priorities[] = {Min,Min + (Max - Min) / 4,Min + (Max - Min) / 2,Min + (Max - Min) / 4,Max};
+				static int Max = sched_get_priority_max(SCHED_OTHER);
+				if(Max==-1) {
+					WARN("Impossible to compute maximum ", name(), " thread priority, ",strerror(errno));
+				} else {
+					static int Priorities[] = {Min,Min + (Max - Min) / 4,Min + (Max - Min) / 2,Min + (Max - Min) / 4,Max};
 
-				struct sched_param params;
-				params.sched_priority = Priorities[_priority];
-				int result;
-				if ((result=pthread_setschedparam(pthread_self(), SCHED_OTHER , &params)))
-					WARN("Impossible to change ", name(), " thread priority to ", Priorities[_priority]," ",strerror(result));
+					struct sched_param params;
+					params.sched_priority = Priorities[_priority];
+					int result;
+					if ((result=pthread_setschedparam(pthread_self(), SCHED_OTHER , &params)))
+						WARN("Impossible to change ", name(), " thread priority to ", Priorities[_priority]," ",strerror(result));
+				}
 			}
 		}
 #endif
 
+		// set affinity
+		if (!_processors.empty()) {
+#if defined(_WIN32)
+			DWORD_PTR mask(0);
+			for (uint16_t processor : _processors) {
+				if (processor < sizeof(mask) * 8)
+					mask |= DWORD_PTR(1) << processor;
+			}
+			if (!SetThreadAffinityMask(GetCurrentThread(), mask))
+				WARN("Impossible to pin ", name(), " thread on processors ", String::Format<DWORD_PTR>("%llx", mask), ", error ", GetLastError());
+#elif defined(__linux__)
+			cpu_set_t cpus;
+			CPU_ZERO(&cpus);
+			for (uint16_t processor : _processors)
+				CPU_SET(processor, &cpus);
+			int result;
+			if ((result = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus)))
+				WARN("Impossible to pin ", name(), " thread on processors ", ToString(_processors), ", ", strerror(result));
+#else
+			WARN("Impossible to pin ", name(), " thread on processors ", ToString(_processors), ", unsupported by this OS");
+#endif
+		}
+
+		// read back effective placement
+		{
+			lock_guard<mutex> lock(_mutexPlacement);
+			_placement.clear();
+#if defined(__linux__)
+			cpu_set_t cpus;
+			if (!pthread_getaffinity_np(pthread_self(), sizeof(cpus), &cpus)) {
+				for (uint16_t processor = 0; processor < CPU_SETSIZE; ++processor) {
+					if (CPU_ISSET(processor, &cpus))
+						_placement.emplace(processor);
+				}
+			}
+#else
+			_placement = _processors; // no way to read it back
+#endif
+#if defined(_WIN32)
+			_placementRealTime = GetThreadPriority(GetCurrentThread()) == THREAD_PRIORITY_TIME_CRITICAL;
+#else
+			int policy;
+			struct sched_param params;
+			_placementRealTime = !pthread_getschedparam(pthread_self(), &policy, &params) && policy == SCHED_FIFO;
+#endif
+		}
+
 		Exception ex;
 		AUTO_ERROR(run(ex, _requestStop), name());
 #if defined(NDEBUG)
@@ -160,6 +228,46 @@ void Thread::process() {
 	_stop = true;
 }
 
+bool Thread::placement(Processors& processors, bool& realTime) const {
+	if (_stop)
+		return false;
+	lock_guard<mutex> lock(_mutexPlacement);
+	processors = _placement;
+	realTime = _placementRealTime;
+	return true;
+}
+
+bool Thread::ParseProcessors(const string& value, Processors& processors) {
+	processors.clear();
+	const char* current(value.c_str());
+	while (*current) {
+		while (isspace(*current))
+			++current;
+		if (!isdigit(*current))
+			return false;
+		char* end;
+		unsigned long first(strtoul(current, &end, 10)), last(first);
+		if (*end == '-') {
+			current = end + 1;
+			if (!isdigit(*current))
+				return false;
+			last = strtoul(current, &end, 10);
+		}
+		if (last < first || last > 0xFFFF)
+			return false;
+		while (first <= last)
+			processors.emplace(uint16_t(first++));
+		current = end;
+		while (isspace(*current))
+			++current;
+		if (*current == ',')
+			++current;
+		else if (*current)
+			return false;
+	}
+	return true;
+}
+
 void Thread::requestStop() {
 	_requestStop = true; // advise thread (intern)
 	wakeUp.set();
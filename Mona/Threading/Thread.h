@@ -19,6 +19,7 @@ details (or else see http://mozilla.org/MPL/2.0/).
 #include "Mona/Util/Exceptions.h"
 #include "Mona/Threading/Signal.h"
 #include <thread>
+#include <set>
 
 namespace Mona {
 
@@ -37,10 +38,34 @@ struct Thread : virtual Object {
 	void 						requestStop();
 	void						stop();
 
+	/*!
+	Set of processors (from 0 to ProcessorCount()-1), empty means any processor */
+	typedef std::set<uint16_t>	Processors;
+	/*!
+	Pin the thread on processors, empty to let the system scheduling it on any processor.
+	Applied on next start */
+	const Processors&			affinity() const { return _processors; }
+	void						setAffinity(const Processors& processors) { _processors = processors; }
+	/*!
+	Pin the thread on processor, -1 to let the system scheduling it on any processor */
+	void						setAffinity(int32_t processor) { _processors.clear(); if (processor >= 0) _processors.emplace(processor); }
+	/*!
+	Real-time scheduling (SCHED_FIFO on posix, time critical on Windows, priority is mapped in the real-time range),
+	requires privileges (CAP_SYS_NICE on Linux), applied on next start */
+	bool						realTime() const { return _realTime; }
+	void						setRealTime(bool value) { _realTime = value; }
+	/*!
+	Effective placement of the running thread read back from the system (configuration can be refused by the system),
+	returns false if the thread is not running */
+	bool						placement(Processors& processors, bool& realTime) const;
+
 	virtual const std::string&	name() const { return typeOf(self); }
 	bool						running() const { return !_stop; }
 	
 	static unsigned				ProcessorCount() { unsigned result(std::thread::hardware_concurrency());  return result ? result : 1; }
+	/*!
+	Parse a list of processors like "0-3,8" (same format as Linux cpusets), returns false if invalid */
+	static bool					ParseProcessors(const std::string& value, Processors& processors);
 	
 	/*!
 	A sleep, usefull for test, with imprecise milliseconds resolution (resolution from 5 to 15ms) */
@@ -73,6 +98,12 @@ private:
 	static thread_local Thread*			_Me;
 
 	Priority		_priority;
+	Processors		_processors;
+	bool			_realTime;
+	// effective placement
+	Processors			_placement;
+	bool				_placementRealTime;
+	mutable std::mutex	_mutexPlacement;
 	volatile bool	_stop;
 	volatile bool	_requestStop;
 
@@ -15,16 +15,47 @@ details (or else see http://mozilla.org/MPL/2.0/).
 */
 
 #include "Mona/Threading/ThreadPool.h"
+#include "Mona/Util/Util.h"
+#include "Mona/Timing/Time.h"
 
 using namespace std;
 
 
 namespace Mona {
 
-void ThreadPool::init(uint16_t threads, Thread::Priority priority) {
+void ThreadPool::init(uint16_t threads, Thread::Priority priority, bool affinity) {
 	_threads.resize(_size = threads ? threads : Thread::ProcessorCount());
-	for (uint16_t i = 0; i < _size; ++i)
+	_minThreads = _active = _size;
+	_maxWait = 1000;
+	_scaleTime = _shrinkTime = 0;
+	for (uint16_t i = 0; i < _size; ++i) {
 		_threads[i].set(priority);
+		_threads[i]->_pPool = this;
+		_threads[i]->_index = i;
+		if (affinity)
+			_threads[i]->setAffinity(i % Thread::ProcessorCount());
+	}
+}
+
+ThreadPool& ThreadPool::setAffinity(const Thread::Processors& processors, bool spread) {
+	auto it(processors.begin());
+	for (Unique<ThreadQueue>& pThread : _threads) {
+		if (!spread || processors.empty()) {
+			pThread->setAffinity(processors);
+			continue;
+		}
+		pThread->setAffinity(*it);
+		if (++it == processors.end())
+			it = processors.begin();
+	}
+	return self;
+}
+
+ThreadPool& ThreadPool::setElastic(uint16_t minThreads, uint32_t maxWait) {
+	_maxWait = maxWait;
+	_active = _minThreads = minThreads ? min(minThreads, _size) : 1;
+	_shrinkTime = Time::Now();
+	return self;
 }
 
 uint16_t ThreadPool::join() {
@@ -38,4 +69,133 @@ uint16_t ThreadPool::join() {
 	return count;
 }
 
+uint16_t ThreadPool::assign() const {
+	if (_minThreads < _size)
+		scale();
+	uint16_t active(_active);
+	uint16_t index(_current++ % active);
+	switch (_assignment) {
+		case ASSIGNMENT_LEAST_LOADED: {
+			// scan from the round-robin index to spread equal loads
+			uint32_t best(score(index));
+			for (uint16_t i = 1; best && i < active; ++i) {
+				uint32_t value(score((index + i) % active));
+				if (value < best) {
+					best = value;
+					index = (index + i) % active;
+				}
+			}
+			break;
+		}
+		case ASSIGNMENT_TWO_CHOICES: {
+			if (active < 2)
+				break;
+			uint16_t other((index + 1 + Util::Random<uint16_t>() % (active - 1)) % active);
+			if (score(other) < score(index))
+				index = other;
+			break;
+		}
+		default:;
+	}
+	return index + 1;
+}
+
+bool ThreadPool::rebalance(uint16_t& track) const {
+	if (!track)
+		return false;
+	if (_minThreads < _size)
+		scale();
+	uint16_t index(track - 1);
+	bool retired(index >= _active); // always leave a retired thread
+	if (!retired && _assignment == ASSIGNMENT_ROUND_ROBIN)
+		return false;
+	if (_threads[index]->queueing())
+		return false; // not drained, moving would break order of track
+	uint16_t other(assign() - 1);
+	// move only on a significant difference of load to avoid a ping-pong of tracks between threads
+	if (other == index || (!retired && score(other) + 25 > score(index)))
+		return false;
+	track = other + 1;
+	return true;
+}
+
+void ThreadPool::scale() const {
+	int64_t now(Time::Now()), time(_scaleTime);
+	if (now - time < 10 || !_scaleTime.compare_exchange_strong(time, now))
+		return; // decided recently or by an other thread
+	uint16_t active(_active), idles(0);
+	uint32_t wait(0xFFFFFFFF);
+	for (uint16_t i = 0; i < active; ++i) {
+		const ThreadQueue& thread(*_threads[i]);
+		if (!thread._busy && !thread.queueing())
+			++idles;
+		wait = min(wait, thread.wait());
+	}
+	if (wait > _maxWait) {
+		// even the less busy thread makes wait too long
+		if (active < _size) {
+			_active = active + 1;
+			_shrinkTime = now;
+		}
+		return;
+	}
+	if (idles < 2 || active <= _minThreads || now - _shrinkTime < 1000)
+		return;
+	_shrinkTime = now;
+	_active = --active;
+	_threads[active]->wakeUp.set(); // to wait now with the short timeout of a retired thread
+}
+
+void ThreadPool::Batch::flush() {
+	for (uint16_t i = 0; i < _runners.size(); ++i) {
+		if (!_runners[i].empty())
+			_threadPool._threads[i]->queue(_runners[i]);
+	}
+}
+
+void ThreadPool::share(Shared<Runner>&& pRunner) const {
+	if (_minThreads < _size)
+		scale();
+	uint16_t active(_active);
+	uint16_t index(_current++ % active);
+	// prefer an idle thread
+	for (uint16_t i = 0; i < active; ++i) {
+		if (!_threads[(index + i) % active]->_busy) {
+			_threads[(index + i) % active]->share(move(pRunner));
+			return;
+		}
+	}
+	_threads[index]->share(move(pRunner));
+	// a thread getting idle meanwhile has maybe checked stealables before this share, wake it up to steal it
+	for (uint16_t i = 0; i < active; ++i) {
+		if (!_threads[i]->_busy) {
+			_threads[i]->wakeUp.set();
+			return;
+		}
+	}
+}
+
+bool ThreadPool::stealable(const ThreadQueue& thief) const {
+	if (!_stealing)
+		return false;
+	for (const Unique<ThreadQueue>& pThread : _threads) {
+		if (pThread.get() != &thief && pThread->_shared)
+			return true;
+	}
+	return false;
+}
+
+Shared<Runner> ThreadPool::steal(const ThreadQueue& thief) const {
+	if (!_stealing)
+		return nullptr;
+	for (const Unique<ThreadQueue>& pThread : _threads) {
+		if (pThread.get() == &thief)
+			continue;
+		Shared<Runner> pRunner(pThread->steal());
+		if (pRunner)
+			return pRunner;
+	}
+	return nullptr;
+}
+
 } // namespace Mona
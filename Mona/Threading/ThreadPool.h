@@ -23,32 +23,150 @@ details (or else see http://mozilla.org/MPL/2.0/).
 namespace Mona {
 
 struct ThreadPool : virtual Object {
-	ThreadPool(uint16_t threads = 0) : _current(0) { init(threads); }
-	ThreadPool(Thread::Priority priority, uint16_t threads = 0) : _current(0) { init(threads, priority); }
+	/*!
+	affinity pins every thread on one processor (round-robin), to keep memory of its runners local on NUMA system (see BufferPool) */
+	ThreadPool(uint16_t threads = 0, bool affinity = false) : _current(0), _stealing(false), _assignment(ASSIGNMENT_ROUND_ROBIN) { init(threads, Thread::PRIORITY_NORMAL, affinity); }
+	ThreadPool(Thread::Priority priority, uint16_t threads = 0, bool affinity = false) : _current(0), _stealing(false), _assignment(ASSIGNMENT_ROUND_ROBIN) { init(threads, priority, affinity); }
+	~ThreadPool() { join(); } // stop all threads before to delete them (a thread can steal from an other)
 
 	uint16_t	threads() const { return _size; }
+	/*!
+	Thread of the track, from 1 to threads() (0 is an unassigned track), to read its metrics (queueing, busyTime, load) */
+	const ThreadQueue& thread(uint16_t track) const { return *_threads[track - 1]; }
+
+	/*!
+	Policy to assign a thread to a new track (on first queue with a track to 0):
+	- ROUND_ROBIN (default), threads in turn
+	- LEAST_LOADED, thread with the smaller queue depth and then smaller load (see ThreadQueue::load), costs a scan of all threads
+	- TWO_CHOICES, less loaded of two random threads, almost as good as LEAST_LOADED with a constant cost */
+	enum Assignment {
+		ASSIGNMENT_ROUND_ROBIN = 0,
+		ASSIGNMENT_LEAST_LOADED,
+		ASSIGNMENT_TWO_CHOICES
+	};
+	Assignment	assignment() const { return _assignment; }
+	ThreadPool&	setAssignment(Assignment assignment) { _assignment = assignment; return self; }
+
+	/*!
+	Move track to a less loaded thread if its thread is drained (nothing queued or running) and is busier than an other thread,
+	returns true if moved. Keeps order of runners on track only if called by the unique producer of this track */
+	bool		rebalance(uint16_t& track) const;
+
+	/*!
+	Elastic mode, disabled by default (minThreads = threads()): new tracks go only to active threads, from minThreads to threads(),
+	one thread more is activated when a runner queued on any active thread would wait more than maxWait microseconds (see ThreadQueue::wait),
+	and one is retired when at least two active threads are idle since 1 second. A retired thread keeps its tracks until rebalance moves them,
+	and stops after 1 second without runners rather than 2 minutes */
+	uint16_t	active() const { return _active; }
+	uint16_t	minThreads() const { return _minThreads; }
+	uint32_t	maxWait() const { return _maxWait; }
+	ThreadPool&	setElastic(uint16_t minThreads, uint32_t maxWait = 1000);
 
 	uint16_t	join();
 
+	/*!
+	Work-stealing mode, disabled by default: a runner queued without track (nullptr) goes preferably to an idle thread,
+	and can be stolen by an idle thread rather than waiting behind a slow runner. Runners queued on a track keep their order on their thread */
+	bool		stealing() const { return _stealing; }
+	ThreadPool&	setStealing(bool value) { _stealing = value; return self; }
+
+	/*!
+	Spin budget of threads before to park when waiting runners, 0 by default (see Signal) */
+	uint32_t	spin() const { return _threads[0]->wakeUp.spin(); }
+	ThreadPool&	setSpin(uint32_t spin) { for (Unique<ThreadQueue>& pThread : _threads) pThread->wakeUp.setSpin(spin); return self; }
+
+	/*!
+	Weight of LANE_HIGH runners on LANE_NORMAL runners for all threads (see ThreadQueue::setLaneWeight) */
+	uint8_t		laneWeight() const { return _threads[0]->laneWeight(); }
+	ThreadPool&	setLaneWeight(uint8_t weight) { for (Unique<ThreadQueue>& pThread : _threads) pThread->setLaneWeight(weight); return self; }
+
+	/*!
+	Pin threads on processors, spread pins each thread on one processor of the set in turn,
+	otherwise every thread can run on all of them (cpuset), applied on next start of threads (see Thread::setAffinity) */
+	ThreadPool&	setAffinity(const Thread::Processors& processors, bool spread = false);
+	/*!
+	Real-time scheduling of threads, applied on next start of threads (see Thread::setRealTime) */
+	ThreadPool&	setRealTime(bool value) { for (Unique<ThreadQueue>& pThread : _threads) pThread->setRealTime(value); return self; }
+
 	template<typename RunnerType>
 	void queue(uint16_t& thread, RunnerType&& pRunner) const {
-		if (thread)
-			return _threads[thread - 1]->queue(std::forward<RunnerType>(pRunner));
-		_threads[thread = (_current++%_size)]->queue(std::forward<RunnerType>(pRunner));
-		++thread;
+		if (!thread)
+			thread = assign();
+		_threads[thread - 1]->queue(std::forward<RunnerType>(pRunner));
 	}
 	template<typename RunnerType>
-	void queue(std::nullptr_t, RunnerType&& pRunner) const { uint16_t thread(0); queue<RunnerType>(thread, std::forward<RunnerType>(pRunner)); }
+	void queue(std::nullptr_t, RunnerType&& pRunner) const {
+		if (_stealing)
+			return share(std::forward<RunnerType>(pRunner));
+		uint16_t thread(0);
+		queue<RunnerType>(thread, std::forward<RunnerType>(pRunner));
+	}
 	template <typename RunnerType, typename ...Args>
-	void queue(uint16_t& thread, Args&&... args) const { queue(thread, std::make_shared<RunnerType>(std::forward<Args>(args)...)); }
+	void queue(uint16_t& thread, Args&&... args) const { queue(thread, Runner::Make<RunnerType>(std::forward<Args>(args)...)); }
 	template <typename RunnerType, typename ...Args>
-	void queue(std::nullptr_t, Args&&... args) const { uint16_t thread(0); queue<RunnerType>(thread, std::forward<Args>(args)...); }
+	void queue(std::nullptr_t, Args&&... args) const { queue(nullptr, Runner::Make<RunnerType>(std::forward<Args>(args)...)); }
+	/*!
+	Queue runners at once on thread track (one CAS and one wake up at most), runners is cleared */
+	void queue(uint16_t& thread, std::vector<Shared<Runner>>& runners) const {
+		if (!thread)
+			thread = assign();
+		_threads[thread - 1]->queue(runners);
+	}
+
+	/*!
+	Batch of runners on different tracks (fan-out), grouped by thread on flush to queue them at once by thread.
+	Runners of a same track keep their order */
+	struct Batch : virtual Object {
+		Batch(const ThreadPool& threadPool) : _threadPool(threadPool), _runners(threadPool._size) {}
+		~Batch() { flush(); }
+
+		template<typename RunnerType>
+		Batch& add(uint16_t& thread, RunnerType&& pRunner) {
+			if (!thread)
+				thread = _threadPool.assign();
+			_runners[thread - 1].emplace_back(std::forward<RunnerType>(pRunner));
+			return self;
+		}
+		template <typename RunnerType, typename ...Args>
+		Batch& add(uint16_t& thread, Args&&... args) { return add(thread, Runner::Make<RunnerType>(std::forward<Args>(args)...)); }
+		/*!
+		Queue added runners, called on destruction */
+		void flush();
+	private:
+		const ThreadPool&							_threadPool;
+		std::vector<std::vector<Shared<Runner>>>	_runners; // by thread
+	};
 private:
-	void init(uint16_t threads, Thread::Priority priority = Thread::PRIORITY_NORMAL);
+	void init(uint16_t threads, Thread::Priority priority, bool affinity);
+	/*!
+	Returns a track (thread index + 1) for a new track, according to assignment policy */
+	uint16_t assign() const;
+	/*!
+	Activate or retire a thread in elastic mode according to queue metrics, one decision every 10ms at most */
+	void	 scale() const;
+	/*!
+	Score to compare thread loads, queue depth first (a queued runner weighs as a full busy thread) */
+	uint32_t score(uint16_t index) const { return _threads[index]->queueing() * 100 + _threads[index]->load(); }
+	void share(Shared<Runner>&& pRunner) const;
+	/*!
+	Steal the oldest stealable runner of an other thread than thief */
+	Shared<Runner> steal(const ThreadQueue& thief) const;
+	/*!
+	True if an other thread than thief has stealable runners, without lock */
+	bool		   stealable(const ThreadQueue& thief) const;
 
 	mutable std::vector<Unique<ThreadQueue>>	_threads;
 	mutable std::atomic<uint16_t>					_current;
 	uint16_t										_size;
+	std::atomic<bool>								_stealing;
+	std::atomic<Assignment>							_assignment;
+	std::atomic<uint16_t>							_minThreads;
+	std::atomic<uint32_t>							_maxWait;
+	mutable std::atomic<uint16_t>					_active; // threads receiving new tracks
+	mutable std::atomic<int64_t>					_scaleTime;
+	mutable std::atomic<int64_t>					_shrinkTime;
+
+	friend struct ThreadQueue;
 };
 
 
@@ -15,6 +15,8 @@ details (or else see http://mozilla.org/MPL/2.0/).
 */
 
 #include "Mona/Threading/ThreadQueue.h"
+#include "Mona/Threading/ThreadPool.h"
+#include <chrono>
 
 
 using namespace std;
@@ -27,26 +29,115 @@ thread_local ThreadQueue* ThreadQueue::_PCurrent(NULL);
 bool ThreadQueue::run(Exception&, const volatile bool& requestStop) {
 	_PCurrent = this;
 	
+	typedef chrono::steady_clock Clock;
+	Lanes lanes;
 	for (;;) {
-		bool timeout = !wakeUp.wait(120000); // 2 mn of timeout
+		Clock::time_point time(Clock::now());
+		// 2 mn of timeout, 1 s if retired by an elastic pool
+		bool timeout = !wakeUp.wait(_pPool && _index >= _pPool->_active ? 1000 : 120000);
+		uint64_t idle(chrono::duration_cast<chrono::microseconds>(Clock::now() - time).count());
 		for(;;) {
-			deque<Shared<Runner>> runners;
-			{
-				lock_guard<mutex> lock(_mutex);
-				if (_runners.empty()) {
-					if (!timeout && !requestStop)
-						break; // wait more
-					stop(); // to set _stop immediatly!
-					return true;
-				}
-				runners = move(_runners);
+			lanes.pull(_runners);
+			// one stealable runner at a time, the rest stays available for idle threads of the pool
+			Shared<Runner> pStealable(steal());
+			if (!pStealable && !lanes.count() && _pPool)
+				pStealable = _pPool->steal(self);
+			if (!pStealable && !lanes.count()) {
+				lock_guard<mutex> lock(_mutex); // to avoid a restart during stopping
+				if (_shared)
+					continue; // shared meanwhile
+				_busy = false;
+				if (_pPool && _pPool->stealable(self))
+					continue; // shared to a busy thread before to see this one idle (see ThreadPool::share)
+				if (!timeout && !requestStop)
+					break; // wait more
+				if (!_runners.close())
+					continue; // queued meanwhile
+				stop(); // to set _stop immediatly!
+				return true;
 			}
-			for (Shared<Runner>& pRunner : runners) {
+			_busy = true;
+			time = Clock::now();
+			// run as many runners as pulled, and pull between each runner to let pass LANE_HIGH runners queued meanwhile
+			uint32_t runs(lanes.count());
+			for (uint32_t count = runs; count--;) {
+				Shared<Runner> pRunner(lanes.pop(_laneWeight));
 				pRunner->run(pRunner->name);
-				pRunner.reset(); // release resources
+				pRunner.reset(); // release before to decrement _queueing (track drained means runners released)
+				--_queueing;
+				if (!_runners.empty())
+					lanes.pull(_runners);
 			}
+			if (pStealable && ++runs)
+				pStealable->run(pStealable->name);
+			account(chrono::duration_cast<chrono::microseconds>(Clock::now() - time).count(), idle, runs);
+			idle = 0;
 		}
 	}
 }
 
+void ThreadQueue::account(uint64_t busy, uint64_t idle, uint32_t runs) {
+	_busyTime += busy;
+	if (runs) // exponential moving average, 1/8 weight for the last runs (initialized on first runs)
+		_runTime = uint32_t(_runTime ? (uint64_t(_runTime) * 7 + busy / runs) / 8 : busy / runs);
+	if (busy += idle) // exponential moving average, 1/8 weight for the last period
+		_load = uint8_t((_load * 7 + (busy - idle) * 100 / busy) / 8);
+}
+
+void ThreadQueue::Lanes::pull(RunnerQueue& queue) {
+	RunnerQueue::Batch runners(queue);
+	_count += runners.count();
+	while (Shared<Runner> pRunner = runners.pop())
+		_lanes[pRunner->lane < Runner::LANES ? pRunner->lane : Runner::LANE_NORMAL].emplace_back(move(pRunner));
+}
+
+Shared<Runner> ThreadQueue::Lanes::pop(uint8_t weight) {
+	deque<Shared<Runner>>* pLane(&_lanes[Runner::LANE_HIGH]);
+	if (pLane->empty() || (_streak >= weight && !_lanes[Runner::LANE_NORMAL].empty())) {
+		pLane = &_lanes[Runner::LANE_NORMAL];
+		_streak = 0;
+	} else
+		++_streak;
+	if (pLane->empty())
+		return nullptr;
+	Shared<Runner> pRunner(move(pLane->front()));
+	pLane->pop_front();
+	--_count;
+	return pRunner;
+}
+
+void ThreadQueue::wake(bool start) {
+	if (start) {
+		// queue closed => thread stopped or stopping, wait its stop end (_mutex) to restart it
+		lock_guard<mutex> lock(_mutex);
+		Thread::start(_priority);
+	}
+	wakeUp.set();
+}
+
+void ThreadQueue::share(Shared<Runner>&& pRunner) {
+	DEBUG_ASSERT(pRunner); // more easy to debug that if it fails in the thread!
+	if (Scheduler::TryQueue(self, move(pRunner)))
+		return;
+	std::lock_guard<std::mutex> lock(_mutex);
+	_runners.open(); // a stopped thread has closed its queue
+	start(_priority);
+	pRunner->queued();
+	_stealables.emplace_back(move(pRunner));
+	++_shared;
+	wakeUp.set();
+}
+
+Shared<Runner> ThreadQueue::steal() {
+	if (!_shared)
+		return nullptr;
+	lock_guard<mutex> lock(_mutex);
+	if (_stealables.empty())
+		return nullptr;
+	Shared<Runner> pRunner(move(_stealables.front()));
+	_stealables.pop_front();
+	--_shared;
+	return pRunner;
+}
+
 } // namespace Mona
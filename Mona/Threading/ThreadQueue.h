@@ -18,35 +18,114 @@ details (or else see http://mozilla.org/MPL/2.0/).
 
 #include "Mona/Mona.h"
 #include "Mona/Threading/Thread.h"
-#include "Mona/Threading/Runner.h"
+#include "Mona/Threading/RunnerQueue.h"
+#include "Mona/Threading/Scheduler.h"
 #include <deque>
 
 namespace Mona {
 
+struct ThreadPool;
 struct ThreadQueue : Thread, virtual Object {
-	ThreadQueue(Priority priority = PRIORITY_NORMAL) : _priority(priority) {}
+	ThreadQueue(Priority priority = PRIORITY_NORMAL) : _priority(priority), _runners(true), _pPool(NULL), _index(0), _shared(0), _busy(false), _queueing(0), _busyTime(0), _load(0), _runTime(0), _laneWeight(8) {}
 	virtual ~ThreadQueue() { stop(); }
 
 	static ThreadQueue*	Current() { return _PCurrent; }
 
+	/*!
+	Runners queued or running on this thread (queue depth) */
+	uint32_t	queueing() const { return _queueing + _shared; }
+	/*!
+	Time spent to run runners since thread creation, in microseconds */
+	uint64_t	busyTime() const { return _busyTime; }
+	/*!
+	Recent occupation of the thread, in percent (moving average of busy time on busy+idle time) */
+	uint8_t		load() const { return _load; }
+	/*!
+	Recent duration of a runner, in microseconds (moving average) */
+	uint32_t	runTime() const { return _runTime; }
+	/*!
+	Estimated wait of a runner queued now, in microseconds (queue depth x runTime) */
+	uint32_t	wait() const { return uint32_t(std::min<uint64_t>(uint64_t(queueing()) * _runTime, 0xFFFFFFFF)); }
+
+	/*!
+	Number of LANE_HIGH runners run in a row before to run one LANE_NORMAL runner when both lanes are pending, 8 by default (see Runner::Lane) */
+	uint8_t			laneWeight() const { return _laneWeight; }
+	ThreadQueue&	setLaneWeight(uint8_t weight) { _laneWeight = weight ? weight : 1; return self; }
+
 	template<typename RunnerType>
 	void queue(RunnerType&& pRunner) {
 		DEBUG_ASSERT(pRunner); // more easy to debug that if it fails in the thread!
-		std::lock_guard<std::mutex> lock(_mutex);
-		start(_priority);
-		_runners.emplace_back(std::forward<RunnerType>(pRunner));
-		wakeUp.set();
+		if (Scheduler::TryQueue(self, std::forward<RunnerType>(pRunner)))
+			return;
+		++_queueing;
+		RunnerQueue::State state(_runners.push(std::forward<RunnerType>(pRunner)));
+		if (state) // wake up only if queue was empty
+			wake(state == RunnerQueue::STATE_CLOSED);
 	}
 	template <typename RunnerType, typename ...Args>
-	void queue(Args&&... args) { queue(std::make_shared<RunnerType>(std::forward<Args>(args)...)); }
+	void queue(Args&&... args) { queue(Runner::Make<RunnerType>(std::forward<Args>(args)...)); }
+	/*!
+	Queue runners at once (one CAS and one wake up at most), runners is cleared */
+	void queue(std::vector<Shared<Runner>>& runners) {
+		if (Scheduler::TryQueue(self, runners))
+			return;
+		uint32_t count(uint32_t(runners.size()));
+		_queueing += count;
+		RunnerQueue::State state(_runners.push(runners));
+		if (state) // wake up only if queue was empty
+			wake(state == RunnerQueue::STATE_CLOSED);
+	}
 
 private:
 	bool run(Exception& ex, const volatile bool& requestStop);
+	/*!
+	Account busy and idle durations (in microseconds) of runs to metrics */
+	void account(uint64_t busy, uint64_t idle, uint32_t runs);
 
-	std::deque<Shared<Runner>>			_runners;
-	std::mutex							_mutex;
+	/*!
+	Lanes of runners taken from the queue, consumer only */
+	struct Lanes : virtual Object {
+		Lanes() : _count(0), _streak(0) {}
+		uint32_t		count() const { return _count; }
+		/*!
+		Move runners queued to their lane */
+		void			pull(RunnerQueue& queue);
+		/*!
+		Next runner to run, weight is the number of LANE_HIGH runners run in a row before to let pass a LANE_NORMAL runner */
+		Shared<Runner>	pop(uint8_t weight);
+	private:
+		std::deque<Shared<Runner>>	_lanes[Runner::LANES];
+		uint32_t					_count;
+		uint8_t						_streak; // LANE_HIGH runners run in a row
+	};
+	/*!
+	Wake up the thread, start it if the queue was closed (thread stopped or stopping) */
+	void wake(bool start);
+
+	/*!
+	Queue a runner which can be stolen by an other thread of the pool */
+	void share(Shared<Runner>&& pRunner);
+	/*!
+	Pop the oldest runner which can be stolen, returns an empty Shared<Runner> if nothing */
+	Shared<Runner> steal();
+
+	RunnerQueue							_runners; // closed when thread is stopped
+	std::deque<Shared<Runner>>			_stealables; // runners without track (see ThreadPool::setStealing)
+	std::mutex							_mutex; // protect _stealables and thread start/stop
 	static thread_local ThreadQueue*	_PCurrent;
 	Priority							_priority;
+	const ThreadPool*					_pPool; // pool to steal runners from when idle
+	uint16_t							_index; // in _pPool
+	std::atomic<uint32_t>				_shared; // _stealables size
+	std::atomic<bool>					_busy;
+	std::atomic<uint32_t>				_queueing; // tracked runners queued or running
+	std::atomic<uint64_t>				_busyTime;
+	std::atomic<uint8_t>				_load;
+	std::atomic<uint32_t>				_runTime;
+	std::atomic<uint8_t>				_laneWeight;
+
+	friend struct ThreadPool;
+	friend struct Scheduler;
 };
 
 
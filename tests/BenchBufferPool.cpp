@@ -0,0 +1,50 @@
+#include "Mona/Mona.h"
+#include "Mona/Memory/BufferPool.h"
+#include <chrono>
+#include <vector>
+
+using namespace std;
+using namespace Mona;
+
+/*
+Alloc/free throughput of Buffer by allocator and number of threads,
+every thread keeps a window of live buffers with various sizes (64B to 16KB) to look like a Receive load.
+Usage: BenchBufferPool [maxThreads=ProcessorCount] [iterations=1000000] */
+
+static double Run(uint32_t threads, uint32_t iterations) {
+    vector<thread> workers;
+    auto start = chrono::steady_clock::now();
+    for (uint32_t t = 0; t < threads; ++t) {
+        workers.emplace_back([iterations, t]() {
+            Unique<Buffer> window[16];
+            uint32_t seed = t;
+            for (uint32_t i = 0; i < iterations; ++i) {
+                seed = seed * 1103515245 + 12345;
+                window[i & 15].set(64u << ((seed >> 16) % 9)); // 64B to 16KB
+                *window[i & 15]->data() = char(i);
+            }
+        });
+    }
+    for (thread& worker : workers)
+        worker.join();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return threads * iterations / seconds / 1000000; // Mops/s
+}
+
+int main(int argc, char** argv) {
+    uint32_t maxThreads = argc > 1 ? atoi(argv[1]) : Thread::ProcessorCount();
+    uint32_t iterations = argc > 2 ? atoi(argv[2]) : 1000000;
+
+    printf("%-8s %16s %16s %16s\n", "threads", "new/delete", "pool (no cache)", "pool (cache)");
+    for (uint32_t threads = 1; threads <= maxThreads; threads *= 2) {
+        Buffer::Allocator::Set();
+        double def = Run(threads, iterations);
+        Buffer::Allocator::Set<BufferPool>(0);
+        double shared = Run(threads, iterations);
+        Buffer::Allocator::Set<BufferPool>();
+        double cached = Run(threads, iterations);
+        printf("%-8u %11.2f Mop/s %11.2f Mop/s %11.2f Mop/s\n", threads, def, shared, cached);
+    }
+    Buffer::Allocator::Set();
+    return 0;
+}
@@ -0,0 +1,61 @@
+#include "Mona/Mona.h"
+#include "Mona/Threading/ThreadPool.h"
+#include "Mona/Memory/Packet.h"
+#include <chrono>
+#include <vector>
+
+using namespace std;
+using namespace Mona;
+
+/*
+Fan-out of a same Packet to subscribers (like a publication sent to every subscriber on its sending track),
+queued runner by runner and then with ThreadPool::Batch (one CAS and one wake up by thread).
+Usage: BenchFanOut [threads=ProcessorCount] [subscribers=10000] [rounds=100] */
+
+typedef chrono::steady_clock Clock;
+
+struct Send : Runner, virtual Object {
+    Send(const Packet& packet, atomic<uint64_t>& bytes) : Runner("Send"), _packet(packet), _bytes(bytes) {}
+private:
+    bool run(Exception& ex) { _bytes.fetch_add(_packet.size(), memory_order_relaxed); return true; }
+    Packet                _packet;
+    atomic<uint64_t>&    _bytes;
+};
+
+template<bool batch>
+static void Run(ThreadPool& threadPool, uint32_t subscribers, uint32_t rounds) {
+    vector<uint16_t> tracks(subscribers, 0);
+    atomic<uint64_t> bytes(0);
+    Packet packet(Shared<Buffer>(SET, 1200)); // shared buffer, not copied by subscriber
+    double queueing(0);
+    auto start = Clock::now();
+    for (uint32_t round = 0; round < rounds; ++round) {
+        auto time = Clock::now();
+        if (batch) {
+            ThreadPool::Batch runners(threadPool);
+            for (uint16_t& track : tracks)
+                runners.add<Send>(track, packet, bytes);
+        } else {
+            for (uint16_t& track : tracks)
+                threadPool.queue<Send>(track, packet, bytes);
+        }
+        queueing += chrono::duration<double, micro>(Clock::now() - time).count();
+    }
+    threadPool.join();
+    double seconds = chrono::duration<double>(Clock::now() - start).count();
+    CHECK(bytes == uint64_t(subscribers) * rounds * packet.size());
+    printf("%-10s %14.2f %14.2f %14.2f\n", batch ? "batch" : "one by one", queueing / rounds, queueing * 1000 / rounds / subscribers, uint64_t(subscribers) * rounds / seconds / 1000000);
+}
+
+int main(int argc, char** argv) {
+    uint16_t threads = argc > 1 ? atoi(argv[1]) : Thread::ProcessorCount();
+    uint32_t subscribers = argc > 2 ? atoi(argv[2]) : 10000;
+    uint32_t rounds = argc > 3 ? atoi(argv[3]) : 100;
+
+    ThreadPool threadPool(threads);
+    printf("%u threads, %u subscribers\n", threads, subscribers);
+    printf("%-10s %14s %14s %14s\n", "mode", "queueing(us)", "ns/subscriber", "Msends/s");
+    Run<false>(threadPool, subscribers, rounds);
+    Run<true>(threadPool, subscribers, rounds);
+    return 0;
+}
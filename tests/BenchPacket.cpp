@@ -0,0 +1,53 @@
+#include "Mona/Mona.h"
+#include "Mona/Memory/Packet.h"
+#include <chrono>
+#include <vector>
+
+using namespace std;
+using namespace Mona;
+
+/*
+Throughput of Packet::identicalBytes against a byte by byte loop, from 16B to 4MB,
+the two packets differ only by their last byte (worst case of delta detection between two frames).
+Usage: BenchPacket [bytes=1GB compared by size] */
+
+static uint32_t IdenticalBytes(const Packet& packet1, const Packet& packet2) {
+    uint32_t size = min(packet1.size(), packet2.size());
+    uint32_t i;
+    for (i = 0; i < size; ++i) {
+        if (packet1.data()[i] != packet2.data()[i])
+            break;
+    }
+    return i;
+}
+
+template<typename FunctionType>
+static double Run(const Packet& packet1, const Packet& packet2, uint64_t bytes, FunctionType&& function) {
+    uint32_t iterations = uint32_t(max<uint64_t>(bytes / packet1.size(), 1));
+    uint64_t result = 0;
+    auto start = chrono::steady_clock::now();
+    for (uint32_t i = 0; i < iterations; ++i)
+        result += function(packet1, packet2);
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    CHECK(result == uint64_t(iterations) * (packet1.size() - 1));
+    return double(iterations) * packet1.size() / seconds / 1000000000; // GB/s
+}
+
+int main(int argc, char** argv) {
+    uint64_t bytes = argc > 1 ? atoll(argv[1]) : 0x40000000;
+
+    vector<char> data1(0x400000), data2(0x400000);
+    for (uint32_t i = 0; i < data1.size(); ++i)
+        data1[i] = data2[i] = char(i * 7);
+
+    printf("%-10s %16s %16s\n", "size", "scalar", "identicalBytes");
+    for (uint32_t size = 16; size <= data1.size(); size *= 4) {
+        data2[size - 1] ^= 0x80;
+        Packet packet1(data1.data(), size), packet2(data2.data(), size);
+        double scalar = Run(packet1, packet2, bytes / 8, IdenticalBytes);
+        double simd = Run(packet1, packet2, bytes, [](const Packet& packet1, const Packet& packet2) { return packet1.identicalBytes(packet2); });
+        printf("%-10u %11.2f GB/s %11.2f GB/s\n", size, scalar, simd);
+        data2[size - 1] ^= 0x80;
+    }
+    return 0;
+}
@@ -0,0 +1,77 @@
+#include "Mona/Mona.h"
+#include "Mona/Threading/ThreadPool.h"
+#include "Mona/Threading/Handler.h"
+#include <chrono>
+
+using namespace std;
+using namespace Mona;
+
+/*
+Allocations and throughput of runners queued from a ThreadPool to a Handler (like Receive -> Handle of IOSocket),
+with std::make_shared (before) and Runner::Make (after, recycled by Slab).
+Usage: BenchRunner [threads=ProcessorCount] [runners=1000000] */
+
+static atomic<uint64_t> Allocations(0);
+
+void* operator new(size_t size) {
+    ++Allocations;
+    if (void* data = malloc(size))
+        return data;
+    throw bad_alloc();
+}
+void operator delete(void* data) noexcept { free(data); }
+void operator delete(void* data, size_t size) noexcept { free(data); }
+
+struct Handle : Runner, virtual Object {
+    Handle(uint32_t value) : Runner("Handle"), _value(value) {}
+private:
+    bool run(Exception& ex) { return _value != 0xFFFFFFFF; }
+    uint32_t _value;
+};
+
+template<bool pooled>
+struct Receive : Runner, virtual Object {
+    Receive(const Handler& handler, uint32_t value) : Runner("Receive"), _handler(handler), _value(value) {}
+private:
+    bool run(Exception& ex) {
+        if (pooled)
+            _handler.queue<Handle>(_value);
+        else
+            _handler.queue(make_shared<Handle>(_value));
+        return true;
+    }
+    const Handler&	_handler;
+    uint32_t		_value;
+};
+
+template<bool pooled>
+static void Run(ThreadPool& threadPool, uint32_t runners) {
+    Signal signal;
+    Handler handler(signal);
+    uint32_t handled(0);
+    Allocations = 0;
+    auto start = chrono::steady_clock::now();
+    for (uint32_t i = 0; i < runners; ++i) {
+        if (pooled)
+            threadPool.queue<Receive<pooled>>(nullptr, handler, i);
+        else
+            threadPool.queue(nullptr, make_shared<Receive<pooled>>(handler, i));
+        if ((i & 0x3FF) == 0x3FF)
+            handled += handler.flush();
+    }
+    threadPool.join();
+    handled += handler.flush();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    printf("%-14s %12.2f %14.2f Mrunners/s\n", pooled ? "Runner::Make" : "make_shared", double(Allocations) / handled, handled / seconds / 1000000);
+}
+
+int main(int argc, char** argv) {
+    uint16_t threads = argc > 1 ? atoi(argv[1]) : Thread::ProcessorCount();
+    uint32_t runners = argc > 2 ? atoi(argv[2]) : 1000000;
+
+    ThreadPool threadPool(threads);
+    printf("%-14s %12s %25s\n", "allocation", "allocs/event", "throughput");
+    Run<false>(threadPool, runners);
+    Run<true>(threadPool, runners);
+    return 0;
+}
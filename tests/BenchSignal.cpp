@@ -0,0 +1,46 @@
+#include "Mona/Mona.h"
+#include "Mona/Threading/Signal.h"
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace Mona;
+
+/*
+Ping-pong latency between two threads through two Signals (like a hand-off IOSocket -> ThreadPool -> Handler),
+parking immediatly (spin=0) and then with different spin budgets.
+Usage: BenchSignal [roundtrips=100000] */
+
+typedef chrono::steady_clock Clock;
+
+static void Run(uint32_t spin, uint32_t roundtrips) {
+    Signal ping(true, spin), pong(true, spin);
+    thread ponger([&]() {
+        for (uint32_t i = 0; i < roundtrips; ++i) {
+            ping.wait();
+            pong.set();
+        }
+    });
+    vector<double> latencies(roundtrips);
+    auto start = Clock::now();
+    for (double& latency : latencies) {
+        auto time = Clock::now();
+        ping.set();
+        pong.wait();
+        latency = chrono::duration<double, micro>(Clock::now() - time).count();
+    }
+    double seconds = chrono::duration<double>(Clock::now() - start).count();
+    ponger.join();
+    sort(latencies.begin(), latencies.end());
+    printf("%-10u %10.2f %10.2f %10.2f %14.0f\n", spin, latencies[roundtrips / 2], latencies[roundtrips * 99 / 100], latencies.back(), roundtrips / seconds);
+}
+
+int main(int argc, char** argv) {
+    uint32_t roundtrips = argc > 1 ? max(atoi(argv[1]), 100) : 100000;
+    printf("%-10s %10s %10s %10s %14s\n", "spin", "p50 (us)", "p99 (us)", "max (us)", "roundtrips/s");
+    for (uint32_t spin : { 0, 100, 1000, 10000 })
+        Run(spin, roundtrips);
+    return 0;
+}
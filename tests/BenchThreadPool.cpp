@@ -0,0 +1,60 @@
+#include "Mona/Mona.h"
+#include "Mona/Threading/ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+using namespace std;
+using namespace Mona;
+
+/*
+Latency (from queueing to end of run) of untracked runners with skewed durations, with and without work-stealing:
+1% of runners last 5ms (like a TLS handshake or a big decode), others 20us.
+Usage: BenchThreadPool [threads=ProcessorCount] [runners=20000] */
+
+typedef chrono::steady_clock Clock;
+
+static void Spin(uint32_t microseconds) {
+    Clock::time_point end(Clock::now() + chrono::microseconds(microseconds));
+    while (Clock::now() < end);
+}
+
+struct Task : Runner, virtual Object {
+    Task(uint32_t duration, double& latency) : Runner("Task"), _duration(duration), _latency(latency), _queued(Clock::now()) {}
+private:
+    bool run(Exception& ex) {
+        Spin(_duration);
+        _latency = chrono::duration<double, micro>(Clock::now() - _queued).count();
+        return true;
+    }
+    uint32_t			_duration;
+    double&				_latency;
+    Clock::time_point	_queued;
+};
+
+static void Run(uint16_t threads, uint32_t runners, bool stealing) {
+    ThreadPool threadPool(threads);
+    threadPool.setStealing(stealing);
+    vector<double> latencies(runners);
+    auto start = Clock::now();
+    for (uint32_t i = 0; i < runners; ++i) {
+        threadPool.queue<Task>(nullptr, (i % 100) == 99 ? 5000 : 20, latencies[i]);
+        if ((i % 10) == 9)
+            Spin(870 / threads); // ~70us by runner on average, 80% of load
+    }
+    threadPool.join();
+    double seconds = chrono::duration<double>(Clock::now() - start).count();
+    sort(latencies.begin(), latencies.end());
+    printf("%-10s %10.0f %10.0f %10.0f %10.0f %10.0f %12.2f\n", stealing ? "stealing" : "tracks", latencies[runners / 2], latencies[runners * 99 / 100], latencies[runners * 999 / 1000], latencies.back(), seconds * 1000, runners / seconds / 1000);
+}
+
+int main(int argc, char** argv) {
+    uint16_t threads = argc > 1 ? atoi(argv[1]) : Thread::ProcessorCount();
+    uint32_t runners = argc > 2 ? atoi(argv[2]) : 20000;
+
+    printf("%u threads, latencies in us\n", threads);
+    printf("%-10s %10s %10s %10s %10s %10s %12s\n", "mode", "p50", "p99", "p99.9", "max", "total(ms)", "Krunners/s");
+    Run(threads, runners, false);
+    Run(threads, runners, true);
+    return 0;
+}
@@ -0,0 +1,81 @@
+#include "Mona/Mona.h"
+#include "Mona/Memory/ArenaAllocator.h"
+
+using namespace std;
+using namespace Mona;
+
+int main(int argc, char** argv) {
+    ArenaAllocator& arena = Buffer::Allocator::Set<ArenaAllocator>(0x800000); // 8MB
+    CHECK(arena.reserved() == 0x800000);
+
+    // Small buffers are served by BufferPool
+    {
+        Buffer buffer(1000);
+        CHECK(arena.used() == 0);
+    }
+
+    // Big buffers are carved out of the arena and recycled
+    const char* data;
+    {
+        Buffer buffer(0x100000);
+        CHECK(arena.used() == 0x100000);
+        memset(buffer.data(), 1, buffer.size());
+        data = buffer.data();
+    }
+    {
+        Buffer buffer(0x100000);
+        CHECK(buffer.data() == data && arena.used() == 0x100000);
+    }
+
+    // Slots are aligned on their capacity, until huge page size
+    {
+        Buffer buffer1(0x20000), buffer2(0x200000);
+        CHECK(arena.used() == 0x400000);
+        CHECK(((buffer2.data() - data) & 0x1FFFFF) == 0);
+    }
+
+    // Clipped buffer is released with its original capacity
+    {
+        Buffer buffer(0x100000);
+        buffer.clip(100);
+        CHECK(buffer.data() == data + 100);
+    }
+    {
+        Buffer buffer(0x100000);
+        CHECK(buffer.data() == data);
+    }
+
+    // Resize moves content from a slot to a bigger one
+    {
+        Buffer buffer("hello", 5);
+        buffer.resize(0x40000);
+        CHECK(memcmp(buffer.data(), "hello", 5) == 0);
+        buffer.resize(0x200000);
+        CHECK(memcmp(buffer.data(), "hello", 5) == 0);
+    }
+
+    // Arena full => fall back on BufferPool
+    {
+        Buffer buffer(0x800000);
+        CHECK(arena.used() <= 0x800000);
+        memset(buffer.data(), 2, buffer.size());
+    }
+
+    // Allocator replaced while arena buffers are alive: arena is retired until the release of its last buffer
+    {
+        CHECK(arena.owned() == 0);
+        Unique<Buffer> pBuffer(SET, 0x100000), pSmall(SET, 1000);
+        CHECK(arena.owned() == 1);
+        Buffer::Allocator::Set<BufferPool>();
+        memset(pBuffer->data(), 3, pBuffer->size()); // still mapped
+        CHECK(arena.owned() == 1);
+        pSmall.reset(); // not owned by arena, freed by the new allocator
+        CHECK(arena.owned() == 1);
+        pBuffer.reset(); // freed by the retired arena, deleted then
+        Buffer buffer(0x100000); // new allocator
+        memset(buffer.data(), 4, buffer.size());
+    }
+
+    Buffer::Allocator::Set();
+    return 0;
+}
@@ -0,0 +1,175 @@
+#include "Mona/Mona.h"
+#include "Mona/Memory/BufferPool.h"
+#include "Mona/Timing/Time.h"
+#include <set>
+
+using namespace std;
+using namespace Mona;
+
+int main(int argc, char** argv) {
+    BufferPool& pool = Buffer::Allocator::Set<BufferPool>();
+    vector<BufferPool::Stats> stats;
+
+    // Thread cache reuses the last buffer released
+    const char* data;
+    {
+        Buffer buffer(100);
+        CHECK(buffer.capacity() == 128);
+        data = buffer.data();
+    }
+    {
+        Buffer buffer(120);
+        CHECK(buffer.data() == data);
+    }
+
+    // Resize keeps content and releases old buffer to the pool
+    {
+        Buffer buffer("hello", 5);
+        buffer.resize(1000);
+        CHECK(buffer.capacity() == 1024);
+        CHECK(memcmp(buffer.data(), "hello", 5) == 0);
+    }
+
+    // Buffers released by a thread are given back to the shared tiers on thread exit
+    set<const char*> released;
+    thread([&released]() {
+        vector<Unique<Buffer>> buffers;
+        for (uint32_t i = 0; i < 100; ++i) {
+            buffers.emplace_back(SET, 2000);
+            released.emplace(buffers.back()->data());
+        }
+    }).join();
+    {
+        Buffer buffer(2000);
+        CHECK(released.count(buffer.data()) == 1);
+    }
+
+    // Statistics: 100 pushes of 2KB from the thread exited, 1 pop from the main thread, the rest held by the shared tier
+    pool.stats(stats);
+    CHECK(stats.size() == 28 && stats[7].capacity == 2048);
+    CHECK(stats[7].pushes == 101 && stats[7].pops == 1);
+    CHECK(stats[7].misses == 100);
+    CHECK(stats[7].held == 100 && stats[7].bytes() == 100 * 2048);
+    CHECK(stats[7].highWater >= 84);
+    CHECK(stats[3].misses == 1 && stats[3].pops == 1 && stats[3].pushes == 2 && stats[3].held == 1); // 128B
+    CHECK(stats[3].hitRate() == 50);
+
+    // Big buffers are not cached by thread but still recycled
+    {
+        Buffer buffer(0x100000);
+        data = buffer.data();
+    }
+    {
+        Buffer buffer(0x100000);
+        CHECK(buffer.data() == data);
+    }
+    pool.stats(stats);
+    CHECK(stats[16].misses == 1 && stats[16].pops == 1 && stats[16].pushes == 2 && stats[16].highWater == 1);
+
+    // Concurrent alloc/free with buffers going from one thread to an other
+    vector<thread> threads;
+    mutex mutex;
+    vector<Shared<Buffer>> exchange;
+    for (uint32_t t = 0; t < 4; ++t) {
+        threads.emplace_back([&mutex, &exchange, t]() {
+            for (uint32_t i = 0; i < 10000; ++i) {
+                Shared<Buffer> pBuffer(SET, (i % 64) * 50 + t);
+                memset(pBuffer->data(), t, pBuffer->size());
+                lock_guard<std::mutex> lock(mutex);
+                exchange.emplace_back(move(pBuffer));
+                if (exchange.size() > 32)
+                    exchange.erase(exchange.begin(), exchange.begin() + 16);
+            }
+        });
+    }
+    for (thread& thread : threads)
+        thread.join();
+    exchange.clear();
+    uint64_t pops(0), misses(0), pushes(0);
+    for (const BufferPool::Stats& tier : pool.stats(stats)) {
+        pops += tier.pops;
+        misses += tier.misses;
+        pushes += tier.pushes;
+    }
+    CHECK(pops + misses == pushes); // every buffer allocated has been released
+    pool.log(LOG_DEBUG);
+
+    // Tier cap and memory budget: buffers pushed beyond are released immediately
+    {
+        BufferPool& pool = Buffer::Allocator::Set<BufferPool>(0); // without thread cache, every push reaches the shared tiers
+        pool.setMaxBuffers(0x100000, 2).setMaxBytes(0x300000);
+        CHECK(pool.maxBuffers(0x100000) == 2 && pool.maxBytes() == 0x300000);
+        // capacity rounded up to its tier like an allocation
+        pool.setMaxBuffers(1000, 5).setMaxBuffers(1, 6);
+        CHECK(pool.maxBuffers(1024) == 5 && pool.maxBuffers(600) == 5 && pool.maxBuffers(16) == 6 && pool.maxBuffers(0) == 6);
+        CHECK(pool.maxBuffers(0x80000001) == 0 && pool.maxBuffers(0x80000000) == 0xFFFFFFFF);
+        {
+            Buffer buffer1(0x100000), buffer2(0x100000), buffer3(0x100000), buffer4(0x200000);
+        } // released in reverse order: 2MB accepted, 1MB accepted, 1MB over budget, 1MB over budget
+        pool.stats(stats);
+        CHECK(stats[17].held == 1 && stats[17].rejects == 0);
+        CHECK(stats[16].held == 1 && stats[16].rejects == 2 && stats[16].pushes == 3);
+        pool.setMaxBytes(0x1000000);
+        {
+            Buffer buffer1(0x100000), buffer2(0x100000), buffer3(0x100000);
+        } // budget is large now, but tier cap is 2
+        pool.stats(stats);
+        CHECK(stats[16].held == 2 && stats[16].rejects == 3);
+
+        // GC sweep interval: buffers unused during a sweep are released by the next one
+        pool.setSweepInterval(50);
+        CHECK(pool.sweepInterval() == 50);
+        Time time;
+        while (pool.stats(stats)[16].held && !time.isElapsed(5000))
+            this_thread::sleep_for(chrono::milliseconds(10));
+        CHECK(stats[16].held == 0 && stats[16].evictions == 2 && stats[17].held == 0);
+    }
+
+    // NUMA mode: buffers given back to the tiers of their memory node, and reused by a thread of this node
+    {
+        BufferPool& pool = Buffer::Allocator::Set<BufferPool>(32, true);
+        CHECK(pool.nodes() >= 1);
+        thread([]() {
+            vector<Unique<Buffer>> buffers;
+            for (uint32_t i = 0; i < 100; ++i) {
+                buffers.emplace_back(SET, 0x1000);
+                memset(buffers.back()->data(), 0, 0x1000); // touch memory to place it on the node
+            }
+        }).join();
+        pool.stats(stats);
+        CHECK(stats[8].held == 100 && stats[8].pushes == 100);
+        {
+            Buffer buffer(0x1000);
+            pool.stats(stats);
+            CHECK(stats[8].pops + stats[8].misses == 101); // pop if this thread runs on the same node
+        }
+    }
+
+    // Thread cache going from one alive pool to an other: it's unregistered from the previous one with its buffers and statistics,
+    // and on thread exit stats() doesn't see it anymore
+    {
+        struct Pool : BufferPool {
+            using BufferPool::alloc;
+            using BufferPool::free;
+        } pool1, pool2;
+        thread([&pool1, &pool2]() {
+            for (uint32_t i = 0; i < 10; ++i) {
+                Pool& pool(i % 2 ? pool2 : pool1);
+                uint32_t capacity(128);
+                pool.free(pool.alloc(capacity), capacity);
+            }
+        }).join();
+        for (Pool* pPool : { &pool1, &pool2 }) {
+            pPool->stats(stats);
+            CHECK(stats[3].misses == 1 && stats[3].pops == 4 && stats[3].pushes == 5 && stats[3].held == 1);
+        }
+    }
+
+    // Back to default allocator
+    Buffer::Allocator::Set();
+    {
+        Buffer buffer(100);
+        CHECK(buffer.capacity() == 128);
+    }
+    return 0;
+}
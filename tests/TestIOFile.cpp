@@ -0,0 +1,51 @@
+#include "Mona/Mona.h"
+#include "Mona/Disk/IOFile.h"
+
+using namespace std;
+using namespace Mona;
+
+static uint32_t Wait(Signal& signal, Handler& handler, const uint32_t& done, uint32_t expected) {
+    while (done < expected && signal.wait(5000))
+        handler.flush();
+    return done;
+}
+
+int main(int argc, char** argv) {
+    Signal signal;
+    Handler handler(signal);
+    ThreadPool threadPool(1);
+    IOFile io(handler, threadPool, 2); // 4 io threads
+    io.ioPool().setElastic(4); // all active, files get a track on each one
+    CHECK(io.ioPool().threads() == 4);
+
+    // Write files (subscription flushes immediatly, then one flush by write)
+    uint32_t flushes(0);
+    File::OnError onError([](const Exception& ex) { CHECK(false); });
+    File::OnFlush onFlush([&flushes](bool deletion) { ++flushes; });
+    vector<Shared<File>> files;
+    for (uint32_t i = 0; i < 4; ++i) {
+        files.emplace_back(SET, Path(Path::CurrentDir(), String("TestIOFile", i, ".tmp")), File::MODE_WRITE);
+        io.subscribe(files.back(), onError, onFlush);
+        io.write(files.back(), Packet("hello"));
+    }
+    CHECK(Wait(signal, handler, flushes, 8) == 8);
+
+    // Threads 3 and 4 retired: a drained file leaves its retired thread on its next operation, which stays stopped
+    io.ioPool().setElastic(2);
+    io.ioPool().join();
+    for (const Shared<File>& pFile : files)
+        io.write(pFile, Packet("world"));
+    CHECK(Wait(signal, handler, flushes, 12) == 12);
+    CHECK(!io.ioPool().thread(3).running() && !io.ioPool().thread(4).running());
+
+    // Deletion
+    for (const Shared<File>& pFile : files) {
+        CHECK(pFile->written() == 10);
+        io.erase(pFile);
+    }
+    CHECK(Wait(signal, handler, flushes, 16) == 16);
+    for (const Shared<File>& pFile : files)
+        CHECK(!pFile->exists(true));
+    io.join();
+    return 0;
+}
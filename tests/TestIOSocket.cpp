@@ -0,0 +1,151 @@
+#include "Mona/Mona.h"
+#include "Mona/Net/IOSocket.h"
+#include "Mona/Net/IOUring.h"
+#include "Mona/Net/TCPServer.h"
+#include "Mona/Net/TCPClient.h"
+#include "Mona/Net/UDPSocket.h"
+
+using namespace std;
+using namespace Mona;
+
+static uint32_t Wait(Signal& signal, Handler& handler, const uint32_t& done, uint32_t expected) {
+    while (done < expected && signal.wait(5000))
+        handler.flush();
+    return done;
+}
+
+static void Test(IOSocket::Backend backend, uint16_t reactors = 1) {
+    Signal signal;
+    Handler handler(signal);
+    ThreadPool threadPool(2);
+    IOSocket io(handler, threadPool);
+    io.setBackend(backend).setReactors(reactors);
+    CHECK(io.reactors() == reactors);
+    Exception ex;
+
+    // TCP echo: connections accepted, data echoed (more than the reception buffer), disconnection on both sides
+    {
+        uint32_t done(0);
+        TCPServer server(io);
+        vector<Unique<TCPClient>> peers;
+        server.onError = [](const Exception& ex) { CHECK(false); };
+        server.onConnection = [&](const Shared<Socket>& pSocket) {
+            peers.emplace_back(SET, io);
+            TCPClient& peer(*peers.back());
+            peer.onData = [&peer](Packet& buffer) {
+                Exception ex;
+                CHECK(peer.send(ex, buffer) && !ex);
+                return 0;
+            };
+            peer.onDisconnection = [&](const SocketAddress& address) { ++done; };
+            Exception ex;
+            CHECK(peer.connect(ex, pSocket) && !ex);
+        };
+        CHECK(server.start(ex, IPAddress::Loopback()) && !ex);
+        CHECK(io.backend() == (IOUring::Available() ? backend : IOSocket::BACKEND_POLL));
+        CHECK(io.subscribers() == reactors); // one listening socket by reactor
+        {
+            // address already used, even when listened with SO_REUSEPORT
+            TCPServer other(io);
+            CHECK(!other.start(ex, server->address()) && ex.cast<Ex::Net::Socket>().code == NET_EADDRINUSE);
+            CHECK(io.subscribers() == reactors);
+            ex = nullptr;
+        }
+
+        string buffer(0x100000, 0);
+        for (uint32_t i = 0; i < buffer.size(); ++i)
+            buffer[i] = char(i % 251);
+        const string data(move(buffer));
+        vector<Unique<TCPClient>> clients;
+        vector<string> echoes(8);
+        for (uint32_t i = 0; i < echoes.size(); ++i) {
+            clients.emplace_back(SET, io);
+            TCPClient& client(*clients.back());
+            string& echo(echoes[i]);
+            client.onData = [&echo, &done, &data, i](Packet& buffer) {
+                echo.append(STR buffer.data(), buffer.size());
+                if (echo.size() == (i ? 5 : data.size()))
+                    ++done;
+                return 0;
+            };
+            CHECK(client.connect(ex, server->address()) && !ex);
+            CHECK(client.send(ex, i ? Packet("hello") : Packet(data)) && !ex);
+        }
+        CHECK(Wait(signal, handler, done, 8) == 8 && peers.size() == 8);
+        CHECK(echoes[0] == data);
+        for (uint32_t i = 1; i < echoes.size(); ++i)
+            CHECK(echoes[i] == "hello");
+
+        // client disconnections => peer disconnections
+        clients.clear();
+        CHECK(Wait(signal, handler, done, 16) == 16);
+        peers.clear();
+        server.stop();
+    }
+
+    // UDP echo
+    {
+        uint32_t done(0);
+        UDPSocket server(io), client(io);
+        server.onPacket = [&](Shared<Buffer>& pBuffer, const SocketAddress& address) {
+            Exception ex;
+            CHECK(server.send(ex, Packet(pBuffer), address) && !ex);
+        };
+        string received;
+        client.onPacket = [&](Shared<Buffer>& pBuffer, const SocketAddress& address) {
+            CHECK(address == server->address());
+            CHECK(pBuffer->size() > 10 || pBuffer->capacity() < 0x1000); // small datagram doesn't hold a big reception buffer
+            received.append(STR pBuffer->data(), pBuffer->size());
+            ++done;
+        };
+        CHECK(server.bind(ex, IPAddress::Loopback()) && !ex);
+        CHECK(client.connect(ex, server->address()) && !ex);
+        for (uint32_t i = 0; i < 10; ++i)
+            CHECK(client.send(ex, Packet("0123456789", i + 1)) && !ex);
+        CHECK(Wait(signal, handler, done, 10) == 10 && received.size() == 55);
+        // datagram greater than 4KB received whole by both backends
+        const string big(60000, 'x');
+        CHECK(client.send(ex, Packet(big)) && !ex);
+        CHECK(Wait(signal, handler, done, 11) == 11 && received.size() == 60055);
+    }
+
+    // UDP echo with batched reception, a datagram greater than batch buffers is lost
+    {
+        uint32_t done(0), lost(0);
+        UDPSocket server(io), client(io);
+        CHECK(server->setRecvBatch(ex, 100) && server->recvBatch() == 64); // capped
+        CHECK(server->setRecvBatch(ex, 16, 1024) && !ex && server->recvBatch() == 16);
+        server.onError = [&](const Exception& ex) {
+            CHECK(ex.cast<Ex::Net::Socket>().code == NET_EMSGSIZE);
+            ++lost;
+        };
+        server.onPacket = [&](Shared<Buffer>& pBuffer, const SocketAddress& address) {
+            Exception ex;
+            CHECK(server.send(ex, Packet(pBuffer), address) && !ex);
+        };
+        string received;
+        client.onPacket = [&](Shared<Buffer>& pBuffer, const SocketAddress& address) {
+            received.append(STR pBuffer->data(), pBuffer->size());
+            ++done;
+        };
+        CHECK(server.bind(ex, IPAddress::Loopback()) && !ex);
+        CHECK(client.connect(ex, server->address()) && !ex);
+        const string big(2000, 'x');
+        CHECK(client.send(ex, Packet(big)) && !ex);
+        for (uint32_t i = 0; i < 100; ++i)
+            CHECK(client.send(ex, Packet("0123456789", i % 10 + 1)) && !ex);
+        // io_uring ignores batch mode, its datagram buffers receive the big one
+        const bool batch(io.backend() == IOSocket::BACKEND_POLL);
+        CHECK(Wait(signal, handler, done, batch ? 100 : 101) == (batch ? 100 : 101));
+        CHECK(received.size() == (batch ? 550 : 2550) && lost == (batch ? 1 : 0));
+    }
+}
+
+int main(int argc, char** argv) {
+    Test(IOSocket::BACKEND_POLL);
+    Test(IOSocket::BACKEND_IO_URING);
+    // sockets sharded on 3 reactors
+    Test(IOSocket::BACKEND_POLL, 3);
+    Test(IOSocket::BACKEND_IO_URING, 3);
+    return 0;
+}
@@ -0,0 +1,43 @@
+#include "Mona/Mona.h"
+#include "Mona/Memory/Packet.h"
+#include <vector>
+
+using namespace std;
+using namespace Mona;
+
+// comparison from a static initializer, maybe before the ones of Packet.cpp
+static const uint32_t StaticIdenticalBytes(Packet(EXPC("static hello")).identicalBytes(Packet(EXPC("static world"))));
+
+int main(int argc, char** argv) {
+    CHECK(StaticIdenticalBytes == 7);
+
+    // identicalBytes finds first mismatch at every position, for every size and misalignment (SIMD loops + tails)
+    vector<char> data1(600), data2(600);
+    for (uint32_t i = 0; i < data1.size(); ++i)
+        data1[i] = data2[i] = char(i * 7);
+    for (uint32_t offset = 0; offset < 3; ++offset) {
+        for (uint32_t size = 0; size <= 300; ++size) {
+            Packet packet1(data1.data() + offset, size), packet2(data2.data() + 2 * offset, size);
+            memcpy(data2.data() + 2 * offset, packet1.data(), size);
+            CHECK(packet1.identicalBytes(packet2) == size && packet1 == packet2 && packet1.compare(packet2) == 0);
+            for (uint32_t i = 0; i < size; ++i) {
+                data2[2 * offset + i] ^= 0x80;
+                CHECK(packet1.identicalBytes(packet2) == i && packet2.identicalBytes(packet1) == i);
+                CHECK(packet1 != packet2);
+                data2[2 * offset + i] ^= 0x80;
+            }
+        }
+    }
+
+    // Size is the min of both sizes
+    Packet packet("hello world"), same(packet);
+    CHECK(packet.identicalBytes(Packet("hello")) == 5 && Packet("hello").identicalBytes(packet) == 5);
+    CHECK(packet.identicalBytes(same) == 11 && packet.identicalBytes(nullptr) == 0);
+
+    // Comparisons by size then data
+    CHECK(Packet("abc") < Packet("abd") && Packet("abd") > Packet("abc"));
+    CHECK(Packet("zz") < Packet("abc") && Packet("abc") >= Packet("zz"));
+    CHECK(Packet("abc") <= Packet("abc") && Packet("abc") >= Packet("abc") && !(Packet("abc") < Packet("abc")));
+    CHECK(Packet() == Packet("", 0) && Packet() <= Packet("", 0));
+    return 0;
+}
@@ -0,0 +1,83 @@
+#include "Mona/Mona.h"
+#include "Mona/Memory/PacketList.h"
+#include "Mona/Format/BinaryWriter.h"
+#include "Mona/Disk/File.h"
+#include "Mona/Net/Socket.h"
+
+using namespace std;
+using namespace Mona;
+
+int main(int argc, char** argv) {
+    // Build a list with a header prepended to a payload, without copy
+    Shared<Buffer> pPayload(SET, "payload", 7);
+    const char* payload = pPayload->data();
+    PacketList packets;
+    packets.append(Packet(move(pPayload)));
+    packets.prepend("head:");
+    packets.append(nullptr); // ignored
+    CHECK(packets.count() == 2 && packets.size() == 12);
+    CHECK(packets[1].data() == payload); // shared, not copied
+    char data[12];
+    CHECK(memcmp(packets.copy(data), "head:payload", 12) == 0);
+
+    // Reference and bufferization
+    {
+        PacketList reference(packets);
+        CHECK(reference[1].data() == payload);
+        PacketList copy(move(reference));
+        CHECK(copy.size() == 12 && copy[1].data() == payload && copy[1].buffer() == packets[1].buffer());
+    }
+
+    // Move after a partial sending
+    {
+        PacketList partial(packets);
+        partial += 3;
+        CHECK(partial.count() == 2 && partial.size() == 9 && partial.front() == Packet("d:"));
+        partial += 4;
+        CHECK(partial.count() == 1 && partial.size() == 5 && partial.front() == Packet("yload"));
+        partial += 10;
+        CHECK(!partial && !partial.count());
+    }
+
+    // BinaryWriter
+    {
+        Buffer buffer;
+        BinaryWriter writer(buffer);
+        writer.write8('>').write(packets);
+        CHECK(buffer.size() == 13 && memcmp(buffer.data(), ">head:payload", 13) == 0);
+    }
+
+    // File gather writing
+    {
+        Exception ex;
+        Path path(FileSystem::GetCurrentApp(), ".TestPacketList");
+        {
+            File file(path, File::MODE_WRITE);
+            CHECK(file.write(ex, packets) && !ex);
+        }
+        File file(path, File::MODE_READ);
+        CHECK(file.read(ex, data, sizeof(data)) == 12 && memcmp(data, "head:payload", 12) == 0);
+        CHECK(File(path, File::MODE_DELETE).erase(ex));
+    }
+
+    // Socket gather sending
+    {
+        Exception ex;
+        Socket server(Socket::TYPE_STREAM);
+        CHECK(server.bind(ex, SocketAddress(IPAddress::Loopback(), 0)) && server.listen(ex));
+        Socket client(Socket::TYPE_STREAM);
+        CHECK(client.connect(ex, SocketAddress(IPAddress::Loopback(), server.address().port())));
+        Shared<Socket> pPeer;
+        CHECK(server.accept(ex, pPeer));
+        CHECK(client.write(ex, packets) == 12 && !client.queueing());
+        char received[12];
+        uint32_t size(0);
+        while (size < sizeof(received)) {
+            int count = pPeer->receive(ex, received + size, sizeof(received) - size);
+            CHECK(count > 0);
+            size += count;
+        }
+        CHECK(memcmp(received, "head:payload", 12) == 0);
+    }
+    return 0;
+}
@@ -0,0 +1,95 @@
+#include "Mona/Mona.h"
+#include "Mona/Memory/RingBuffer.h"
+#include "Mona/Net/IOSocket.h"
+#include <vector>
+
+using namespace std;
+using namespace Mona;
+
+int main(int argc, char** argv) {
+    Shared<RingBuffer> pRing(SET, 100);
+    uint32_t capacity = pRing->capacity();
+    CHECK(capacity >= 100 && !(capacity % 4096) && !pRing->size());
+
+    // Views share the ring memory
+    uint32_t size;
+    char* data = pRing->write(size);
+    CHECK(data && size == capacity);
+    memcpy(data, "hello", 5);
+    Shared<Buffer> pHello = RingBuffer::Commit(pRing, 5);
+    CHECK(pHello->data() == data && pHello->size() == 5 && pRing->size() == 5);
+    CHECK(pRing->write(size) == data + 5 && size == capacity - 5);
+
+    // Ring full => no writable area
+    Shared<Buffer> pRest = RingBuffer::Commit(pRing, capacity - 5);
+    CHECK(!pRing->write(size) && !size);
+
+    // Released out of order, the ring moves forward on the oldest one
+    pRest.reset();
+    CHECK(pRing->size() == capacity && !pRing->write(size));
+    pHello.reset();
+    CHECK(!pRing->size());
+
+    // Writable area crosses the end of the ring if mirrored
+    data = pRing->write(size);
+    CHECK(size == capacity);
+    if (pRing->mirrored()) {
+        memset(data, 'x', size);
+        RingBuffer::Commit(pRing, capacity - 2);
+        data = pRing->write(size);
+        CHECK(size == capacity);
+        memcpy(data, "wrap", 4);
+        Shared<Buffer> pWrap = RingBuffer::Commit(pRing, 4);
+        CHECK(memcmp(pWrap->data(), "wrap", 4) == 0);
+        CHECK(memcmp(data - (capacity - 2), "ap", 2) == 0); // same memory at the beginning of the ring
+        pWrap.reset();
+    }
+
+    // View resized beyond its size moves in an allocated buffer
+    data = pRing->write(size);
+    memcpy(data, "abc", 3);
+    Shared<Buffer> pView = RingBuffer::Commit(pRing, 3);
+    pView->append("def", 3);
+    CHECK(pView->data() != data && memcmp(pView->data(), "abcdef", 6) == 0);
+    pView.reset();
+    CHECK(!pRing->size());
+
+    // Stream socket receiving in a ring
+    {
+        Exception ex;
+        Signal signal;
+        Handler handler(signal);
+        ThreadPool threadPool;
+        IOSocket io(handler, threadPool);
+
+        Socket server(Socket::TYPE_STREAM);
+        CHECK(server.bind(ex, SocketAddress(IPAddress::Loopback(), 0)) && server.listen(ex));
+        Socket client(Socket::TYPE_STREAM);
+        CHECK(client.connect(ex, SocketAddress(IPAddress::Loopback(), server.address().port())));
+        Shared<Socket> pPeer;
+        CHECK(server.accept(ex, pPeer));
+        CHECK(pPeer->setRecvRing(ex, 0x10000) && pPeer->recvRing() == 0x10000);
+
+        string received;
+        uint32_t views(0);
+        Socket::OnReceived onReceived([&](Shared<Buffer>& pBuffer, const SocketAddress& address) {
+            received.append(pBuffer->data(), pBuffer->size());
+            ++views;
+        });
+        Socket::OnFlush onFlush([]() {});
+        Socket::OnError onError([](const Exception& ex) {});
+        CHECK(io.subscribe(ex, pPeer, onReceived, onFlush, onError));
+
+        string message(100000, 'm'); // bigger than ring
+        for (uint32_t i = 0; i < message.size(); ++i)
+            message[i] = char(i);
+        Packet packet(message.data(), message.size());
+        CHECK(client.write(ex, packet) == int(packet.size()));
+        while (received.size() < message.size() && signal.wait(5000))
+            handler.flush();
+        CHECK(received == message && views);
+        io.unsubscribe(pPeer);
+        handler.flush();
+    }
+    return 0;
+}
@@ -0,0 +1,147 @@
+#include "Mona/Mona.h"
+#include "Mona/Threading/RunnerQueue.h"
+#include "Mona/Threading/Handler.h"
+#include <vector>
+
+using namespace std;
+using namespace Mona;
+
+struct Count : Runner, virtual Object {
+    Count(vector<uint32_t>& counts, uint32_t producer, uint32_t value) : Runner("Count"), _counts(counts), _producer(producer), _value(value) {}
+private:
+    bool run(Exception& ex) {
+        CHECK(_counts[_producer]++ == _value); // order of each producer kept
+        return true;
+    }
+    vector<uint32_t>&	_counts;
+    uint32_t			_producer;
+    uint32_t			_value;
+};
+
+int main(int argc, char** argv) {
+    // Queue states
+    {
+        vector<uint32_t> counts(1, 0);
+        RunnerQueue queue;
+        CHECK(queue.empty());
+        CHECK(queue.push(Runner::Make<Count>(counts, 0, 0)) == RunnerQueue::STATE_EMPTY);
+        CHECK(queue.push(Runner::Make<Count>(counts, 0, 1)) == RunnerQueue::STATE_FILLED);
+        CHECK(!queue.close() && !queue.empty());
+        {
+            RunnerQueue::Batch runners(queue);
+            CHECK(runners.count() == 2 && queue.empty());
+            while (Shared<Runner> pRunner = runners.pop())
+                pRunner->run(pRunner->name);
+        }
+        CHECK(counts[0] == 2);
+        CHECK(queue.close());
+        Shared<Runner> pRunner(Runner::Make<Count>(counts, 0, 2));
+        CHECK(queue.push(pRunner, false) == RunnerQueue::STATE_CLOSED && queue.empty());
+        CHECK(queue.push(pRunner) == RunnerQueue::STATE_CLOSED && !queue.empty()); // reopened
+        CHECK(RunnerQueue::Batch(queue).count() == 1);
+        CHECK(pRunner.use_count() == 1 && queue.empty()); // released by the batch
+    }
+
+    // Runner queued again before to run: queued through a wrapper, runs as many times as queued
+    {
+        struct Counter : Runner, virtual Object {
+            Counter(uint32_t& count) : Runner("Counter"), _count(count) {}
+        private:
+            bool run(Exception& ex) { ++_count; return true; }
+            uint32_t& _count;
+        };
+        uint32_t count(0);
+        Shared<Runner> pRunner(Runner::Make<Counter>(count));
+        RunnerQueue queue, other;
+        CHECK(queue.push(pRunner) == RunnerQueue::STATE_EMPTY);
+        CHECK(queue.push(pRunner) == RunnerQueue::STATE_FILLED);
+        vector<Shared<Runner>> runners(2, pRunner);
+        CHECK(other.push(runners) == RunnerQueue::STATE_EMPTY && runners.empty());
+        for (RunnerQueue* pQueue : { &queue, &other }) {
+            RunnerQueue::Batch batch(*pQueue);
+            CHECK(batch.count() == 2);
+            while (Shared<Runner> pQueued = batch.pop())
+                pQueued->run(pQueued->name);
+        }
+        CHECK(count == 4 && pRunner.use_count() == 1);
+        CHECK(queue.push(pRunner) == RunnerQueue::STATE_EMPTY && RunnerQueue::Batch(queue).pop() == pRunner); // hook released, queued directly
+    }
+
+    // Batch push
+    {
+        vector<uint32_t> counts(1, 0);
+        RunnerQueue queue;
+        vector<Shared<Runner>> runners;
+        CHECK(queue.push(runners) == RunnerQueue::STATE_FILLED && queue.empty()); // nothing pushed
+        for (uint32_t i = 0; i < 3; ++i)
+            runners.emplace_back(Runner::Make<Count>(counts, 0, i));
+        CHECK(queue.push(runners) == RunnerQueue::STATE_EMPTY && runners.empty());
+        for (uint32_t i = 3; i < 5; ++i)
+            runners.emplace_back(Runner::Make<Count>(counts, 0, i));
+        CHECK(queue.push(runners) == RunnerQueue::STATE_FILLED);
+        {
+            RunnerQueue::Batch batch(queue);
+            CHECK(batch.count() == 5);
+            while (Shared<Runner> pRunner = batch.pop())
+                pRunner->run(pRunner->name);
+        }
+        CHECK(counts[0] == 5 && queue.close());
+        for (uint32_t i = 5; i < 7; ++i)
+            runners.emplace_back(Runner::Make<Count>(counts, 0, i));
+        CHECK(queue.push(runners, false) == RunnerQueue::STATE_CLOSED && queue.empty());
+        CHECK(runners.size() == 2 && runners[0].use_count() == 1 && runners[1].use_count() == 1); // given back in order
+        Signal signal;
+        Handler handler(signal);
+        CHECK(handler.tryQueue(runners) && runners.empty() && handler.backlog() == 2);
+        CHECK(signal.wait(1) && handler.flush() == 2 && counts[0] == 7);
+    }
+
+    // Multiple producers to a Handler
+    {
+        Signal signal;
+        Handler handler(signal);
+        const uint32_t producers = 4, runners = 10000;
+        vector<uint32_t> counts(producers, 0);
+        vector<Unique<thread>> threads;
+        for (uint32_t producer = 0; producer < producers; ++producer) {
+            threads.emplace_back(SET, [&, producer]() {
+                for (uint32_t i = 0; i < runners; ++i)
+                    handler.queue<Count>(counts, producer, i);
+            });
+        }
+        uint32_t handled(0);
+        while (handled < producers * runners && signal.wait(5000))
+            handled += handler.flush();
+        for (Unique<thread>& pThread : threads)
+            pThread->join();
+        handled += handler.flush(true);
+        CHECK(handled == producers * runners);
+        for (uint32_t count : counts)
+            CHECK(count == runners);
+        // closed after the last flush
+        CHECK(!handler.tryQueue<Count>(counts, 0, runners));
+        handler.reset(signal);
+        CHECK(handler.tryQueue<Count>(counts, 0, runners) && handler.flush() == 1 && counts[0] == runners + 1);
+    }
+
+    // Handler backlog and high-water mark
+    {
+        Signal signal;
+        Handler handler(signal);
+        vector<uint32_t> counts(1, 0);
+        CHECK(!handler.highWater() && !handler.saturated());
+        handler.setHighWater(3);
+        for (uint32_t i = 0; i < 3; ++i) {
+            CHECK(!handler.saturated());
+            handler.queue<Count>(counts, 0, i);
+        }
+        CHECK(handler.backlog() == 3 && handler.saturated());
+        handler.queue<Count>(counts, 0, 3); // never refused
+        CHECK(handler.backlog() == 4 && handler.flush() == 4);
+        CHECK(!handler.backlog() && !handler.saturated() && counts[0] == 4);
+        handler.queue<Count>(counts, 0, 4);
+        handler.flush(true);
+        CHECK(!handler.tryQueue<Count>(counts, 0, 5) && !handler.backlog()); // closed
+    }
+    return 0;
+}
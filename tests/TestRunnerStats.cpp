@@ -0,0 +1,62 @@
+#include "Mona/Mona.h"
+#include "Mona/Threading/ThreadPool.h"
+#include "Mona/Threading/Handler.h"
+
+using namespace std;
+using namespace Mona;
+
+struct Sleep : Runner, virtual Object {
+    Sleep(const char* name, uint32_t duration) : Runner(name), _duration(duration) {}
+private:
+    bool run(Exception& ex) { Thread::Sleep(_duration); return true; }
+    uint32_t _duration;
+};
+
+static const RunnerStats::Stats* Find(const vector<RunnerStats::Stats>& stats, const char* name) {
+    for (const RunnerStats::Stats& stat : stats) {
+        if (stat.name == name)
+            return &stat;
+    }
+    return NULL;
+}
+
+int main(int argc, char** argv) {
+    // Buckets
+    for (uint64_t value : { 0ull, 1ull, 15ull, 16ull, 17ull, 1000ull, 123456789ull, 1ull << 40 }) {
+        uint16_t bucket(RunnerStats::BucketOf(value));
+        CHECK(RunnerStats::ValueOf(bucket) <= value && value < RunnerStats::ValueOf(bucket + 1));
+        CHECK(value - RunnerStats::ValueOf(bucket) <= value / 8); // 12.5% precision
+    }
+    CHECK(RunnerStats::BucketOf(0xFFFFFFFFFFFFFFFF) == RunnerStats::BUCKETS - 1);
+
+    // Disabled by default
+    vector<RunnerStats::Stats> stats;
+    ThreadPool threadPool(1);
+    uint16_t track(0);
+    threadPool.queue<Sleep>(track, "Disabled", 0);
+    threadPool.join();
+    CHECK(!RunnerStats::Enabled() && !Find(RunnerStats::Snapshot(stats), "Disabled"));
+
+    // Queue-wait and run times by name
+    RunnerStats::Enable();
+    for (uint32_t i = 0; i < 10; ++i)
+        threadPool.queue<Sleep>(track, "Slow", 10); // each one waits the previous ones
+    threadPool.join();
+    Signal signal;
+    Handler handler(signal);
+    handler.queue<Sleep>("Fast", 0);
+    handler.flush();
+    RunnerStats::Enable(false);
+
+    const RunnerStats::Stats* pSlow(Find(RunnerStats::Snapshot(stats), "Slow"));
+    CHECK(pSlow && pSlow->run.count == 10 && pSlow->wait.count == 10);
+    CHECK(pSlow->run.percentile(50) >= 9000000 && pSlow->run.max >= 10000000 && pSlow->run.mean() >= 10000000);
+    CHECK(pSlow->wait.max >= 80000000 && pSlow->wait.percentile(99) <= pSlow->wait.max);
+    const RunnerStats::Stats* pFast(Find(stats, "Fast"));
+    CHECK(pFast && pFast->run.count == 1 && pFast->wait.count == 1);
+    RunnerStats::Log(LOG_DEBUG);
+
+    RunnerStats::Reset();
+    CHECK(!Find(RunnerStats::Snapshot(stats), "Slow")->run.count);
+    return 0;
+}
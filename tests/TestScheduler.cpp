@@ -0,0 +1,128 @@
+#include "Mona/Mona.h"
+#include "Mona/Threading/Scheduler.h"
+#include "Mona/Threading/ThreadPool.h"
+#include "Mona/Threading/Task.h"
+
+using namespace std;
+using namespace Mona;
+
+struct Trace : Runner, virtual Object {
+    Trace(vector<uint32_t>& values, uint32_t value, const ThreadQueue* pThread = NULL) : Runner("Trace"), _values(values), _value(value), _pThread(pThread) {}
+private:
+    bool run(Exception& ex) {
+        CHECK(Thread::CurrentId() == Thread::MainId && ThreadQueue::Current() == _pThread);
+        _values.emplace_back(_value);
+        return true;
+    }
+    vector<uint32_t>&	_values;
+    uint32_t			_value;
+    const ThreadQueue*	_pThread;
+};
+
+// 3 tracks and the handler, values are track*1000 + order in track
+static vector<uint32_t>& Interleave(uint32_t seed, vector<uint32_t>& values) {
+    Scheduler scheduler(seed);
+    CHECK(Scheduler::Current() == &scheduler && scheduler.seed() == seed);
+    Handler handler;
+    ThreadPool threadPool(3);
+    uint16_t tracks[3] = { 0, 0, 0 };
+    for (uint32_t i = 0; i < 20; ++i) {
+        for (uint32_t t = 0; t < 3; ++t) {
+            threadPool.queue<Trace>(tracks[t], values, (t + 1) * 1000 + i, &threadPool.thread(tracks[t] ? tracks[t] : t + 1));
+            CHECK(tracks[t] == t + 1);
+        }
+        handler.queue<Trace>(values, i);
+    }
+    CHECK(scheduler.pending() == 80 && handler.backlog() == 20 && threadPool.thread(1).queueing() == 20);
+    CHECK(scheduler.run(10) == 10 && scheduler.pending() == 70);
+    CHECK(scheduler.run() == 70 && !scheduler.pending() && scheduler.steps() == 80);
+    CHECK(!handler.backlog() && !threadPool.thread(1).queueing());
+    CHECK(!threadPool.join()); // no thread started
+    return values;
+}
+
+int main(int argc, char** argv) {
+    CHECK(!Scheduler::Current());
+
+    // Same seed replays the same interleaving, every queue keeps its order
+    vector<uint32_t> values1, values2, values3;
+    CHECK(Interleave(7, values1) == Interleave(7, values2));
+    CHECK(Interleave(8, values3) != values1 && values3.size() == values1.size());
+    uint32_t next[4] = { 0, 0, 0, 0 };
+    for (uint32_t value : values1)
+        CHECK(value % 1000 == next[value / 1000]++);
+    CHECK(!Scheduler::Current());
+
+    // LANE_HIGH runners pass first on their queue
+    {
+        Scheduler scheduler;
+        CHECK(scheduler.seed());
+        Handler handler;
+        vector<uint32_t> values;
+        handler.queue<Trace>(values, 1);
+        Shared<Trace> pHigh(SET, values, 0);
+        pHigh->lane = Runner::LANE_HIGH;
+        handler.queue(pHigh);
+        pHigh.reset();
+        CHECK(scheduler.run() == 2 && values == vector<uint32_t>({ 0, 1 }));
+    }
+
+    // Steps of a task chained on pool and handler, runners queued meanwhile are scheduled too
+    {
+        Scheduler scheduler(1);
+        Handler handler;
+        ThreadPool threadPool(2);
+        uint16_t track(0);
+        uint32_t value(0), done(0);
+        Task(handler)
+            .then(threadPool, track, [&](Exception& ex) { CHECK(ThreadQueue::Current() == &threadPool.thread(track)); value = 1; return true; })
+            .then([&](Exception& ex) { CHECK(!ThreadQueue::Current()); value += 10; return true; })
+            .then(threadPool, nullptr, [&](Exception& ex) { value += 100; return true; })
+            .then([&](Exception& ex) { done = 1; return true; })
+            .start();
+        CHECK(scheduler.run() == 4 && done == 1 && value == 111);
+
+        // pending runners are released without run
+        handler.queue<Trace>(values1, 0);
+        scheduler.clear();
+        CHECK(!scheduler.step() && !handler.backlog());
+    }
+
+    // Nested schedulers are restored in reverse order of creation
+    {
+        Scheduler outer;
+        {
+            Scheduler inner;
+            CHECK(Scheduler::Current() == &inner);
+        }
+        CHECK(Scheduler::Current() == &outer);
+    }
+    CHECK(!Scheduler::Current());
+
+    // Producer of an other thread while the scheduler is destroyed: its runners go to the scheduler or to the handler
+    {
+        Signal signal;
+        Handler handler(signal);
+        vector<uint32_t> values;
+        for (uint32_t i = 0; i < 100; ++i) {
+            atomic<bool> started(false);
+            thread producer;
+            {
+                Scheduler scheduler;
+                producer = thread([&handler, &values, &started]() {
+                    for (uint32_t j = 0; j < 1000; ++j) {
+                        handler.queue<Trace>(values, j);
+                        started = true;
+                    }
+                });
+                while (!started)
+                    this_thread::yield();
+            }
+            producer.join();
+            handler.flush();
+            CHECK(!handler.backlog());
+        }
+        CHECK(values.size() && values.size() < 100000);
+    }
+    return 0;
+}
@@ -0,0 +1,55 @@
+#include "Mona/Mona.h"
+#include "Mona/Threading/Signal.h"
+#include <thread>
+
+using namespace std;
+using namespace Mona;
+
+int main(int argc, char** argv) {
+    for (uint32_t spin : { 0, 1000 }) {
+        // auto reset
+        Signal signal(true, spin);
+        CHECK(signal.spin() == spin);
+        CHECK(!signal.wait(1));
+        signal.set();
+        CHECK(signal.wait(1));
+        CHECK(!signal.wait(1)); // reset by the previous wait
+        signal.set();
+        signal.reset();
+        CHECK(!signal.wait(1));
+
+        // manual reset
+        Signal manual(false, spin);
+        manual.set();
+        CHECK(manual.wait(1) && manual.wait(1));
+        manual.reset();
+        CHECK(!manual.wait(1));
+
+        // hand-off between threads, no wake up lost
+        Signal ping(true, spin), pong(true, spin);
+        const uint32_t roundtrips = 10000;
+        thread ponger([&]() {
+            for (uint32_t i = 0; i < roundtrips; ++i) {
+                CHECK(ping.wait(5000));
+                pong.set();
+            }
+        });
+        for (uint32_t i = 0; i < roundtrips; ++i) {
+            ping.set();
+            CHECK(pong.wait(5000));
+        }
+        ponger.join();
+
+        // signal on the stack destroyed by the waiter as soon as it's set, while set is maybe in progress
+        for (uint32_t i = 0; i < 1000; ++i) {
+            thread setter;
+            {
+                Signal done(true, spin);
+                setter = thread([&done]() { done.set(); });
+                CHECK(done.wait(5000));
+            }
+            setter.join();
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,95 @@
+#include "Mona/Mona.h"
+#include "Mona/Memory/Slab.h"
+#include "Mona/Threading/ThreadPool.h"
+#include "Mona/Threading/Handler.h"
+#include <set>
+
+using namespace std;
+using namespace Mona;
+
+struct Work : Runner, virtual Object {
+    Work(atomic<uint32_t>& done) : Runner("Work"), _done(done) {}
+private:
+    bool run(Exception& ex) { ++_done; return true; }
+    atomic<uint32_t>& _done;
+};
+
+int main(int argc, char** argv) {
+    // Block released is reused by the same thread
+    void* block = Slab<64>::Alloc();
+    Slab<64>::Free(block);
+    CHECK(Slab<64>::Alloc() == block);
+    Slab<64>::Free(block);
+
+    // Runner and its control block are recycled
+    atomic<uint32_t> done(0);
+    const void* pWork;
+    {
+        Shared<Work> pRunner = Runner::Make<Work>(done);
+        pWork = pRunner.get();
+    }
+    CHECK(Runner::Make<Work>(done).get() == pWork);
+
+    // Blocks released by an other thread come back by the shared list
+    {
+        vector<void*> blocks;
+        for (uint32_t i = 0; i < 1000; ++i)
+            blocks.push_back(Slab<48>::Alloc());
+        set<void*> allocated(blocks.begin(), blocks.end());
+        thread([&blocks]() {
+            for (void* block : blocks)
+                Slab<48>::Free(block);
+        }).join();
+        for (void*& block : blocks) {
+            block = Slab<48>::Alloc();
+            CHECK(allocated.count(block));
+        }
+        for (void* block : blocks)
+            Slab<48>::Free(block);
+    }
+
+    // A thread takes a batch of the shared list, the rest stays available for other threads
+    {
+        vector<void*> blocks;
+        for (uint32_t i = 0; i < 1000; ++i)
+            blocks.push_back(Slab<80>::Alloc());
+        set<void*> allocated(blocks.begin(), blocks.end());
+        thread([&blocks]() {
+            for (void* block : blocks)
+                Slab<80>::Free(block);
+        }).join();
+        void* block = Slab<80>::Alloc();
+        CHECK(allocated.count(block));
+        thread([&allocated]() {
+            vector<void*> blocks;
+            for (uint32_t i = 0; i < 500; ++i) {
+                blocks.push_back(Slab<80>::Alloc());
+                CHECK(allocated.count(blocks.back()));
+            }
+            for (void* block : blocks)
+                Slab<80>::Free(block);
+        }).join();
+        Slab<80>::Free(block);
+    }
+
+    // Runners queued in ThreadPool and Handler
+    {
+        Signal signal;
+        Handler handler(signal);
+        ThreadPool threadPool(4);
+        atomic<uint32_t> handled(0);
+        struct Job : Runner, virtual Object {
+            Job(const Handler& handler, atomic<uint32_t>& handled) : Runner("Job"), _handler(handler), _handled(handled) {}
+        private:
+            bool run(Exception& ex) { _handler.queue<Work>(_handled); return true; }
+            const Handler& _handler;
+            atomic<uint32_t>& _handled;
+        };
+        for (uint32_t i = 0; i < 10000; ++i)
+            threadPool.queue<Job>(nullptr, handler, handled);
+        threadPool.join();
+        handler.flush();
+        CHECK(handled == 10000);
+    }
+    return 0;
+}
@@ -0,0 +1,77 @@
+#include "Mona/Mona.h"
+#include "Mona/Memory/Slice.h"
+#include "Mona/Net/StreamData.h"
+#include <vector>
+
+using namespace std;
+using namespace Mona;
+
+struct Lines : StreamData<>, virtual Object {
+    uint32_t add(const Packet& packet) { CHECK(addStreamData(packet, 0xFFFF)); return count; }
+
+    vector<string>	lines;
+    Packet			hold; // last line kept by the "user"
+    uint32_t		count = 0;
+private:
+    uint32_t onStreamData(Packet& buffer) {
+        ++count;
+        while (const char* end = (const char*)memchr(buffer.data(), '\n', buffer.size())) {
+            uint32_t size = end - buffer.data();
+            lines.emplace_back(buffer.data(), size);
+            hold.set(std::move(buffer)).shrink(size); // share buffer without copy (unbuffered data are bufferized)
+            buffer += size + 1;
+        }
+        return buffer.size();
+    }
+};
+
+int main(int argc, char** argv) {
+    // Append in place while unique, consumed bytes are skipped without move
+    Slice slice;
+    slice.append(EXPC("hello world"));
+    const char* data = slice.data();
+    slice += 6;
+    CHECK(slice.size() == 5 && memcmp(slice.data(), "world", 5) == 0);
+    slice.append(EXPC("!!"));
+    CHECK(string(slice.data(), slice.size()) == "world!!" && slice.data() == data + 6); // no move, no reallocation
+
+    // Sub-slice and packet share the buffer
+    Slice sub(slice(1, 3));
+    CHECK(sub.size() == 3 && sub.data() == slice.data() + 1);
+    Packet packet(slice.packet());
+    CHECK(packet.data() == slice.data() && packet.size() == slice.size());
+
+    // Shared buffer, even with enough capacity => copy-on-write, buffer of the packet unchanged (size included)
+    data = slice.data();
+    uint32_t size(packet.buffer()->size());
+    slice.append(EXPC("?"));
+    CHECK(slice.data() != data && string(slice.data(), slice.size()) == "world!!?");
+    CHECK(packet.buffer()->size() == size && packet.size() == 7 && memcmp(packet.data(), "world!!", 7) == 0);
+
+    // sub doesn't hold the end => copy-on-write
+    data = sub.data();
+    sub.append(EXPC("X"));
+    CHECK(sub.data() != data && string(sub.data(), sub.size()) == "orlX" && packet.buffer()->size() == size);
+
+    // Unique buffer => appended in place, reallocated if need
+    string big(1000, 'x');
+    slice.append(big.data(), big.size());
+    CHECK(slice.size() == 1008 && memcmp(slice.data(), "world!!?", 8) == 0 && memcmp(packet.data(), "world!!", 7) == 0);
+
+    // Release without copy if unique
+    packet.reset();
+    sub.reset();
+    data = slice.data();
+    Shared<Buffer> pBuffer;
+    CHECK(slice.release(pBuffer)->data() == data && pBuffer->size() == 1008 && !slice);
+
+    // StreamData accumulates partial frames
+    Lines lines;
+    lines.add(Packet(EXPC("first\nsec")));
+    lines.add(Packet(EXPC("ond\nthi")));
+    lines.add(Packet(EXPC("rd")));
+    lines.add(Packet(EXPC("\nfourth\n")));
+    CHECK(lines.lines.size() == 4 && lines.lines[1] == "second" && lines.lines[2] == "third" && lines.lines[3] == "fourth");
+    CHECK(string(lines.hold.data(), lines.hold.size()) == "fourth");
+    return 0;
+}
@@ -0,0 +1,87 @@
+#include "Mona/Mona.h"
+#include "Mona/Threading/Task.h"
+#include <thread>
+
+using namespace std;
+using namespace Mona;
+
+#if defined(MONA_COROUTINES)
+static Task::Coroutine Pipeline(const Handler& handler, const ThreadPool& threadPool, uint16_t& track, const Task::Result<uint32_t>& read, vector<uint32_t>& threads, uint32_t& result) {
+    threads.emplace_back(Thread::CurrentId());
+    uint32_t value = co_await read; // resumed by a callback
+    co_await Task::Hop(threadPool, track);
+    threads.emplace_back(Thread::CurrentId());
+    value *= 2;
+    co_await Task::Hop(handler);
+    threads.emplace_back(Thread::CurrentId());
+    result = value;
+}
+#endif
+
+static uint32_t Wait(Signal& signal, Handler& handler, const uint32_t& done, uint32_t expected) {
+    while (done < expected && signal.wait(5000))
+        handler.flush();
+    return done;
+}
+
+int main(int argc, char** argv) {
+    Signal signal;
+    Handler handler(signal);
+    ThreadPool threadPool(2);
+    uint16_t track(0);
+
+    // Steps chained on pool and handler threads, with a suspended step resumed from an other thread
+    {
+        uint32_t value(0), done(0);
+        atomic<uint32_t> poolThread(0);
+        unique_ptr<thread> pResumer;
+        Task(handler)
+            .then(threadPool, track, [&](Exception& ex) { poolThread = Thread::CurrentId(); value = 1; return true; })
+            .then([&](Exception& ex) { CHECK(Thread::CurrentId() == Thread::MainId && value == 1); value += 10; return true; })
+            .wait([&](const Task::Resume& resume) {
+                pResumer.reset(new thread([resume, &value]() { value += 100; resume(); })); // like a read callback
+            })
+            .then(threadPool, nullptr, [&](Exception& ex) { value += 1000; return true; })
+            .then([&](Exception& ex) { done = 1; return true; })
+            .onError([&](const Exception& ex) { done = 2; })
+            .start();
+        CHECK(Wait(signal, handler, done, 1) == 1 && value == 1111);
+        CHECK(poolThread && poolThread != Thread::MainId);
+        pResumer->join();
+    }
+
+    // A failing step stops the chain and calls onError on handler thread
+    {
+        uint32_t steps(0), done(0);
+        Task(handler)
+            .then(threadPool, track, [&](Exception& ex) { ++steps; ex.set<Ex::Format>("invalid"); return false; })
+            .then([&](Exception& ex) { ++steps; return true; })
+            .onError([&](const Exception& ex) { CHECK(Thread::CurrentId() == Thread::MainId && ex.cast<Ex::Format>()); done = 1; })
+            .start();
+        CHECK(Wait(signal, handler, done, 1) == 1 && steps == 1);
+    }
+
+    // Recycled frames
+    void* frame(Task::AllocFrame(100));
+    Task::FreeFrame(frame, 100);
+    CHECK(Task::AllocFrame(120) == frame); // same size class, same thread
+    Task::FreeFrame(frame, 120);
+    frame = Task::AllocFrame(10000);
+    Task::FreeFrame(frame, 10000);
+
+#if defined(MONA_COROUTINES)
+    {
+        Task::Result<uint32_t> read;
+        vector<uint32_t> threads;
+        uint32_t result(0);
+        Pipeline(handler, threadPool, track, read, threads, result);
+        CHECK(threads.size() == 1); // suspended on read
+        read.set(21);
+        while (!result && signal.wait(5000))
+            handler.flush();
+        CHECK(result == 42 && threads.size() == 3 && threads[1] != Thread::MainId && threads[2] == Thread::MainId);
+    }
+#endif
+    threadPool.join();
+    return 0;
+}
@@ -0,0 +1,201 @@
+#include "Mona/Mona.h"
+#include "Mona/Threading/ThreadPool.h"
+#include "Mona/Application/Application.h"
+#include <chrono>
+#include <vector>
+
+using namespace std;
+using namespace Mona;
+
+struct Task : Runner, virtual Object {
+    Task(atomic<uint32_t>& done, uint32_t duration = 0) : Runner("Task"), _done(done), _duration(duration) {}
+private:
+    bool run(Exception& ex) {
+        if (_duration)
+            Thread::Sleep(_duration);
+        ++_done;
+        return true;
+    }
+    atomic<uint32_t>&	_done;
+    uint32_t			_duration;
+};
+
+struct Ordered : Runner, virtual Object {
+    Ordered(vector<uint32_t>& values, uint32_t value, Lane lane = LANE_NORMAL) : Runner("Ordered", lane), _values(values), _value(value) {}
+private:
+    bool run(Exception& ex) { _values.emplace_back(_value); return true; }
+    vector<uint32_t>&	_values;
+    uint32_t			_value;
+};
+
+struct Block : Runner, virtual Object {
+    Block(atomic<bool>& started, uint32_t duration) : Runner("Block"), _started(started), _duration(duration) {}
+private:
+    bool run(Exception& ex) {
+        _started = true;
+        Thread::Sleep(_duration);
+        return true;
+    }
+    atomic<bool>&	_started;
+    uint32_t		_duration;
+};
+
+struct App : Application, virtual Object {
+    using Application::place;
+private:
+    int main() { return 0; }
+};
+
+int main(int argc, char** argv) {
+    ThreadPool threadPool(2);
+    CHECK(!threadPool.stealing() && threadPool.setStealing(true).stealing());
+
+    // Untracked runners don't wait behind a slow runner
+    atomic<uint32_t> slow(0), fast(0);
+    threadPool.queue<Task>(nullptr, slow, 1000);
+    auto start = chrono::steady_clock::now();
+    for (uint32_t i = 0; i < 20; ++i)
+        threadPool.queue<Task>(nullptr, fast, 10);
+    while (fast < 20 && chrono::steady_clock::now() - start < chrono::milliseconds(800))
+        Thread::Sleep(5);
+    CHECK(fast == 20 && !slow);
+    threadPool.join();
+
+    // Untracked runner queued while the other thread gets idle is not lost behind a slow runner
+    {
+        atomic<uint32_t> slow(0), fast(0);
+        for (uint32_t i = 0; i < 100; ++i) {
+            threadPool.queue<Task>(nullptr, slow, 30);
+            threadPool.queue<Task>(nullptr, fast);
+            start = chrono::steady_clock::now();
+            while (fast == i && chrono::steady_clock::now() - start < chrono::milliseconds(1000))
+                this_thread::yield();
+            CHECK(fast == i + 1 && slow == i);
+            while (slow == i)
+                this_thread::yield();
+        }
+    }
+
+    // Tracked runners keep their order on their thread
+    vector<uint32_t> values;
+    uint16_t track(0);
+    for (uint32_t i = 0; i < 1000; ++i) {
+        threadPool.queue<Ordered>(track, values, i);
+        threadPool.queue<Task>(nullptr, fast);
+    }
+    threadPool.join();
+    CHECK(slow == 1 && fast == 1020 && values.size() == 1000);
+    for (uint32_t i = 0; i < values.size(); ++i)
+        CHECK(values[i] == i);
+
+    // Load-aware assignment of new tracks
+    ThreadPool pool(2);
+    CHECK(pool.setAssignment(ThreadPool::ASSIGNMENT_LEAST_LOADED).assignment() == ThreadPool::ASSIGNMENT_LEAST_LOADED);
+    atomic<uint32_t> done(0);
+    uint16_t busyTrack(0), idleTrack(0);
+    pool.queue<Task>(busyTrack, done, 200);
+    pool.queue<Task>(busyTrack, done, 10);
+    CHECK(busyTrack && pool.thread(busyTrack).queueing() == 2);
+    pool.queue<Task>(idleTrack, done);
+    CHECK(idleTrack && idleTrack != busyTrack); // goes to the idle thread
+    CHECK(!pool.rebalance(busyTrack)); // not drained
+    pool.join();
+    CHECK(done == 3 && !pool.thread(busyTrack).queueing() && pool.thread(busyTrack).busyTime() >= 200000);
+    CHECK(pool.thread(idleTrack).busyTime() < pool.thread(busyTrack).busyTime() && pool.thread(busyTrack).load());
+
+    // Priority lanes with weighted draining
+    {
+        ThreadPool pool(1);
+        CHECK(pool.setLaneWeight(2).laneWeight() == 2);
+        atomic<bool> started(false);
+        uint16_t track(0);
+        pool.queue<Block>(track, started, 50);
+        while (!started)
+            Thread::Sleep(1);
+        vector<uint32_t> values;
+        for (uint32_t i = 0; i < 4; ++i)
+            pool.queue<Ordered>(track, values, i);
+        for (uint32_t i = 100; i < 105; ++i)
+            pool.queue<Ordered>(track, values, i, Runner::LANE_HIGH);
+        pool.join();
+        CHECK(values == vector<uint32_t>({ 100, 101, 0, 102, 103, 1, 104, 2, 3 }));
+    }
+
+    // Batch of runners on different tracks
+    {
+        ThreadPool pool(2);
+        vector<uint32_t> values1, values2;
+        uint16_t track1(0), track2(0);
+        {
+            ThreadPool::Batch batch(pool);
+            for (uint32_t i = 0; i < 100; ++i) {
+                batch.add<Ordered>(track1, values1, i);
+                batch.add<Ordered>(track2, values2, i);
+            }
+            CHECK(track1 && track2 && track1 != track2);
+        } // flushed
+        pool.join();
+        CHECK(values1.size() == 100 && values2.size() == 100);
+        for (uint32_t i = 0; i < 100; ++i)
+            CHECK(values1[i] == i && values2[i] == i);
+    }
+
+    // Elastic mode, grows on queue wait and shrinks when threads are idle
+    {
+        ThreadPool pool(4);
+        CHECK(pool.active() == 4 && pool.setElastic(1, 1000).active() == 1 && pool.minThreads() == 1 && pool.maxWait() == 1000);
+        atomic<uint32_t> done(0);
+        uint32_t count(0);
+        auto start = chrono::steady_clock::now();
+        while (pool.active() < 4 && chrono::steady_clock::now() - start < chrono::seconds(3)) {
+            uint16_t track(0);
+            pool.queue<Task>(track, done, 5);
+            CHECK(track <= pool.active());
+            ++count;
+            Thread::Sleep(1);
+        }
+        CHECK(pool.active() == 4);
+        pool.join();
+        CHECK(done == count && pool.thread(1).runTime() >= 5000 && !pool.thread(1).wait());
+        start = chrono::steady_clock::now();
+        while (pool.active() > 1 && chrono::steady_clock::now() - start < chrono::seconds(6)) {
+            uint16_t track(0);
+            pool.queue<Task>(track, done);
+            Thread::Sleep(20);
+        }
+        CHECK(pool.active() == 1);
+        // a retired track moves to an active thread once drained
+        uint16_t track(4);
+        pool.join();
+        CHECK(pool.rebalance(track) && track == 1);
+        pool.join();
+    }
+
+    // Affinity and placement
+    {
+        Thread::Processors processors;
+        CHECK(Thread::ParseProcessors("0-3, 8,10-11", processors) && processors == Thread::Processors({ 0, 1, 2, 3, 8, 10, 11 }));
+        CHECK(Thread::ParseProcessors("", processors) && processors.empty());
+        CHECK(!Thread::ParseProcessors("3-1", processors) && !Thread::ParseProcessors("1,a", processors) && !Thread::ParseProcessors("-1", processors));
+
+        ThreadPool pool(2);
+        App app;
+        app.setString("pool.affinity", "0");
+        app.setString("pool.spread", "true");
+        CHECK(app.place("pool", pool));
+        app.setString("pool.affinity", "x");
+        CHECK(!app.place("pool", pool));
+
+        atomic<bool> started(false);
+        uint16_t track(0);
+        bool realTime(true);
+        CHECK(!pool.thread(1).placement(processors, realTime)); // not running
+        pool.queue<Block>(track, started, 50);
+        while (!started)
+            Thread::Sleep(1);
+        CHECK(pool.thread(track).affinity() == Thread::Processors({ 0 }));
+        CHECK(pool.thread(track).placement(processors, realTime) && processors == Thread::Processors({ 0 }) && !realTime);
+        pool.join();
+    }
+    return 0;
+}